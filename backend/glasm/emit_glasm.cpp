@@ -6,13 +6,13 @@
 #include <tuple>
 
 #include <shader_compiler/common/div_ceil.h>
-#include <shader_compiler/common/settings.h>
 #include <shader_compiler/backend/bindings.h>
 #include <shader_compiler/backend/glasm/emit_glasm.h>
 #include <shader_compiler/backend/glasm/emit_glasm_instructions.h>
 #include <shader_compiler/backend/glasm/glasm_emit_context.h>
 #include <shader_compiler/frontend/ir/ir_emitter.h>
 #include <shader_compiler/frontend/ir/program.h>
+#include <shader_compiler/instrumentation.h>
 #include <shader_compiler/profile.h>
 #include <shader_compiler/runtime_info.h>
 
@@ -204,7 +204,7 @@ void Precolor(const IR::Program& program) {
     }
 }
 
-void EmitCode(EmitContext& ctx, const IR::Program& program) {
+void EmitCode(EmitContext& ctx, const IR::Program& program, const CompileOptions& options) {
     const auto eval{
         [&](const IR::U1& cond) { return ScalarS32{ctx.reg_alloc.Consume(IR::Value{cond})}; }};
     for (const IR::AbstractSyntaxNode& node : program.syntax_list) {
@@ -226,7 +226,7 @@ void EmitCode(EmitContext& ctx, const IR::Program& program) {
             ctx.Add("REP;");
             break;
         case IR::AbstractSyntaxNode::Type::Repeat:
-            if (!Settings::values.disable_shader_loop_safety_checks) {
+            if (!options.disable_shader_loop_safety_checks) {
                 const u32 loop_index{ctx.num_safety_loop_vars++};
                 const u32 vector_index{loop_index / 4};
                 const char component{"xyzw"[loop_index % 4]};
@@ -397,10 +397,11 @@ std::string_view GetTessSpacing(TessSpacing spacing) {
 } // Anonymous namespace
 
 std::string EmitGLASM(const Profile& profile, const RuntimeInfo& runtime_info, IR::Program& program,
-                      Bindings& bindings) {
+                      Bindings& bindings, const CompileOptions& options) {
+    const PassScope scope{options.instrumentation, "EmitGLASM", &program};
     EmitContext ctx{program, bindings, profile, runtime_info};
     Precolor(program);
-    EmitCode(ctx, program);
+    EmitCode(ctx, program, options);
     std::string header{StageHeader(program.stage)};
     SetupOptions(program, profile, runtime_info, header);
     switch (program.stage) {
@@ -6,6 +6,7 @@
 #include <string>
 
 #include <shader_compiler/backend/bindings.h>
+#include <shader_compiler/compile_options.h>
 #include <shader_compiler/frontend/ir/program.h>
 #include <shader_compiler/profile.h>
 #include <shader_compiler/runtime_info.h>
@@ -15,12 +16,13 @@ namespace Shader::Backend::GLASM {
 constexpr u32 PROGRAM_LOCAL_PARAMETER_STORAGE_BUFFER_BASE = 1;
 
 [[nodiscard]] std::string EmitGLASM(const Profile& profile, const RuntimeInfo& runtime_info,
-                                    IR::Program& program, Bindings& bindings);
+                                    IR::Program& program, Bindings& bindings,
+                                    const CompileOptions& options);
 
 [[nodiscard]] inline std::string EmitGLASM(const Profile& profile, const RuntimeInfo& runtime_info,
-                                           IR::Program& program) {
+                                           IR::Program& program, const CompileOptions& options) {
     Bindings binding;
-    return EmitGLASM(profile, runtime_info, program, binding);
+    return EmitGLASM(profile, runtime_info, program, binding, options);
 }
 
 } // namespace Shader::Backend::GLASM
@@ -7,11 +7,11 @@
 #include <type_traits>
 
 #include <shader_compiler/common/div_ceil.h>
-#include <shader_compiler/common/settings.h>
 #include <shader_compiler/backend/glsl/emit_glsl.h>
 #include <shader_compiler/backend/glsl/emit_glsl_instructions.h>
 #include <shader_compiler/backend/glsl/glsl_emit_context.h>
 #include <shader_compiler/frontend/ir/ir_emitter.h>
+#include <shader_compiler/instrumentation.h>
 
 namespace Shader::Backend::GLSL {
 namespace {
@@ -130,7 +130,7 @@ void Precolor(const IR::Program& program) {
     }
 }
 
-void EmitCode(EmitContext& ctx, const IR::Program& program) {
+void EmitCode(EmitContext& ctx, const IR::Program& program, const CompileOptions& options) {
     for (const IR::AbstractSyntaxNode& node : program.syntax_list) {
         switch (node.type) {
         case IR::AbstractSyntaxNode::Type::Block:
@@ -161,7 +161,7 @@ void EmitCode(EmitContext& ctx, const IR::Program& program) {
             ctx.Add("for(;;){{");
             break;
         case IR::AbstractSyntaxNode::Type::Repeat:
-            if (Settings::values.disable_shader_loop_safety_checks) {
+            if (options.disable_shader_loop_safety_checks) {
                 ctx.Add("if(!{}){{break;}}}}", ctx.var_alloc.Consume(node.data.repeat.cond));
             } else {
                 ctx.Add("if(--loop{}<0 || !{}){{break;}}}}", ctx.num_safety_loop_vars++,
@@ -215,10 +215,11 @@ void DefineVariables(const EmitContext& ctx, std::string& header) {
 } // Anonymous namespace
 
 std::string EmitGLSL(const Profile& profile, const RuntimeInfo& runtime_info, IR::Program& program,
-                     Bindings& bindings) {
+                     Bindings& bindings, const CompileOptions& options) {
+    const PassScope scope{options.instrumentation, "EmitGLSL", &program};
     EmitContext ctx{program, bindings, profile, runtime_info};
     Precolor(program);
-    EmitCode(ctx, program);
+    EmitCode(ctx, program, options);
     const std::string version{fmt::format("#version 460{}\n", GlslVersionSpecifier(ctx))};
     ctx.header.insert(0, version);
     if (program.shared_memory_size > 0) {
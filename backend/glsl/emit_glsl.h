@@ -6,6 +6,7 @@
 #include <string>
 
 #include <shader_compiler/backend/bindings.h>
+#include <shader_compiler/compile_options.h>
 #include <shader_compiler/frontend/ir/program.h>
 #include <shader_compiler/profile.h>
 #include <shader_compiler/runtime_info.h>
@@ -13,11 +14,13 @@
 namespace Shader::Backend::GLSL {
 
 [[nodiscard]] std::string EmitGLSL(const Profile& profile, const RuntimeInfo& runtime_info,
-                                   IR::Program& program, Bindings& bindings);
+                                   IR::Program& program, Bindings& bindings,
+                                   const CompileOptions& options);
 
-[[nodiscard]] inline std::string EmitGLSL(const Profile& profile, IR::Program& program) {
+[[nodiscard]] inline std::string EmitGLSL(const Profile& profile, IR::Program& program,
+                                          const CompileOptions& options) {
     Bindings binding;
-    return EmitGLSL(profile, {}, program, binding);
+    return EmitGLSL(profile, {}, program, binding, options);
 }
 
 } // namespace Shader::Backend::GLSL
@@ -7,12 +7,12 @@
 #include <utility>
 #include <vector>
 
-#include <shader_compiler/common/settings.h>
 #include <shader_compiler/backend/spirv/emit_spirv.h>
 #include <shader_compiler/backend/spirv/emit_spirv_instructions.h>
 #include <shader_compiler/backend/spirv/spirv_emit_context.h>
 #include <shader_compiler/frontend/ir/basic_block.h>
 #include <shader_compiler/frontend/ir/program.h>
+#include <shader_compiler/instrumentation.h>
 
 namespace Shader::Backend::SPIRV {
 namespace {
@@ -117,7 +117,7 @@ Id TypeId(const EmitContext& ctx, IR::Type type) {
     }
 }
 
-void Traverse(EmitContext& ctx, IR::Program& program) {
+void Traverse(EmitContext& ctx, IR::Program& program, const CompileOptions& options) {
     IR::Block* current_block{};
     for (const IR::AbstractSyntaxNode& node : program.syntax_list) {
         switch (node.type) {
@@ -162,7 +162,7 @@ void Traverse(EmitContext& ctx, IR::Program& program) {
             break;
         case IR::AbstractSyntaxNode::Type::Repeat: {
             Id cond{ctx.Def(node.data.repeat.cond)};
-            if (!Settings::values.disable_shader_loop_safety_checks) {
+            if (!options.disable_shader_loop_safety_checks) {
                 const Id pointer_type{ctx.TypePointer(spv::StorageClass::Private, ctx.U32[1])};
                 const Id safety_counter{ctx.AddGlobalVariable(
                     pointer_type, spv::StorageClass::Private, ctx.Const(0x2000u))};
@@ -195,13 +195,13 @@ void Traverse(EmitContext& ctx, IR::Program& program) {
     }
 }
 
-Id DefineMain(EmitContext& ctx, IR::Program& program) {
+Id DefineMain(EmitContext& ctx, IR::Program& program, const CompileOptions& options) {
     const Id void_function{ctx.TypeFunction(ctx.void_id)};
     const Id main{ctx.OpFunction(ctx.void_id, spv::FunctionControlMask::MaskNone, void_function)};
     for (IR::Block* const block : program.blocks) {
         block->SetDefinition(ctx.OpLabel());
     }
-    Traverse(ctx, program);
+    Traverse(ctx, program, options);
     ctx.OpFunctionEnd();
     return main;
 }
@@ -481,9 +481,11 @@ void PatchPhiNodes(IR::Program& program, EmitContext& ctx) {
 } // Anonymous namespace
 
 std::vector<u32> EmitSPIRV(const Profile& profile, const RuntimeInfo& runtime_info,
-                           IR::Program& program, Bindings& bindings) {
+                           IR::Program& program, Bindings& bindings,
+                           const CompileOptions& options) {
+    const PassScope scope{options.instrumentation, "EmitSPIRV", &program};
     EmitContext ctx{profile, runtime_info, program, bindings};
-    const Id main{DefineMain(ctx, program)};
+    const Id main{DefineMain(ctx, program, options)};
     DefineEntryPoint(program, ctx, main);
     if (profile.support_float_controls) {
         ctx.AddExtension("SPV_KHR_float_controls");
@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2026 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <exception>
+#include <optional>
+
+#include <shader_compiler/backend/bindings.h>
+#include <shader_compiler/backend/spirv/emit_spirv.h>
+#include <shader_compiler/batch/batch_compiler.h>
+#include <shader_compiler/common/log.h>
+#include <shader_compiler/frontend/maxwell/translate_program.h>
+#include <shader_compiler/instrumentation.h>
+
+namespace Shader {
+
+BatchCompiler::BatchCompiler(size_t num_workers) : thread_pool{num_workers} {
+    contexts.reserve(thread_pool.NumWorkers());
+    for (size_t index = 0; index < thread_pool.NumWorkers(); ++index) {
+        contexts.push_back(std::make_unique<WorkerContext>());
+    }
+}
+
+BatchCompiler::~BatchCompiler() {
+    thread_pool.WaitIdle();
+}
+
+std::vector<std::future<CompiledShader>> BatchCompiler::Compile(
+    std::span<Environment* const> envs, const Profile& profile, const RuntimeInfo& runtime_info,
+    const HostTranslateInfo& host_info, const CompileOptions& options) {
+    auto state{std::make_shared<const BatchState>(
+        BatchState{profile, runtime_info, host_info, options})};
+    std::vector<std::future<CompiledShader>> futures;
+    futures.reserve(envs.size());
+    std::vector<WorkStealingThreadPool::Task> tasks;
+    tasks.reserve(envs.size());
+    for (Environment* const env : envs) {
+        auto promise{std::make_shared<std::promise<CompiledShader>>()};
+        futures.push_back(promise->get_future());
+        tasks.emplace_back([this, env, state, promise](size_t worker_index) {
+            try {
+                promise->set_value(CompileShader(worker_index, *env, *state));
+            } catch (...) {
+                promise->set_exception(std::current_exception());
+            }
+        });
+    }
+    thread_pool.Submit(std::move(tasks));
+    return futures;
+}
+
+void BatchCompiler::Compile(std::span<Environment* const> envs, const Profile& profile,
+                            const RuntimeInfo& runtime_info, const HostTranslateInfo& host_info,
+                            const CompileOptions& options, CompletionCallback callback) {
+    auto state{std::make_shared<const BatchState>(
+        BatchState{profile, runtime_info, host_info, options})};
+    auto shared_callback{std::make_shared<const CompletionCallback>(std::move(callback))};
+    std::vector<WorkStealingThreadPool::Task> tasks;
+    tasks.reserve(envs.size());
+    for (size_t index = 0; index < envs.size(); ++index) {
+        tasks.emplace_back([this, index, env = envs[index], state,
+                            shared_callback](size_t worker_index) {
+            CompiledShader shader;
+            std::exception_ptr exception;
+            try {
+                shader = CompileShader(worker_index, *env, *state);
+            } catch (...) {
+                exception = std::current_exception();
+            }
+            // An exception escaping the worker would terminate the process, so it's only logged
+            try {
+                (*shared_callback)(index, exception, std::move(shader));
+            } catch (const std::exception& callback_exception) {
+                LOG_ERROR(Shader, "Completion callback of shader {} threw: {}", index,
+                          callback_exception.what());
+            } catch (...) {
+                LOG_ERROR(Shader, "Completion callback of shader {} threw an unknown exception",
+                          index);
+            }
+        });
+    }
+    thread_pool.Submit(std::move(tasks));
+}
+
+void BatchCompiler::WaitIdle() {
+    thread_pool.WaitIdle();
+}
+
+CompiledShader BatchCompiler::CompileShader(size_t worker_index, Environment& env,
+                                            const BatchState& state) {
+    WorkerContext& context{*contexts[worker_index]};
+    // The arena is reset even when translation throws, the program must be destroyed first
+    struct ArenaResetter {
+        ~ArenaResetter() {
+            arena.Reset();
+        }
+        CompilationArena& arena;
+    } const resetter{context.arena};
+
+    std::optional<Maxwell::Flow::CFG> cfg;
+    {
+        const PassScope scope{state.options.instrumentation, "CFG"};
+        cfg.emplace(env, context.arena.FlowBlockPool(), env.StartAddress());
+    }
+    IR::Program program{
+        Maxwell::TranslateProgram(context.arena, env, *cfg, state.host_info, state.options)};
+    Backend::Bindings bindings;
+    std::vector<u32> code{Backend::SPIRV::EmitSPIRV(state.profile, state.runtime_info, program,
+                                                    bindings, state.options)};
+    return CompiledShader{
+        .code = std::move(code),
+        .info = std::move(program.info),
+    };
+}
+
+} // namespace Shader
@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2026 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include <shader_compiler/batch/thread_pool.h>
+#include <shader_compiler/common/common_types.h>
+#include <shader_compiler/compilation_arena.h>
+#include <shader_compiler/compile_options.h>
+#include <shader_compiler/environment.h>
+#include <shader_compiler/host_translate_info.h>
+#include <shader_compiler/profile.h>
+#include <shader_compiler/runtime_info.h>
+#include <shader_compiler/shader_info.h>
+
+namespace Shader {
+
+/// The result of compiling a single shader to SPIR-V
+struct CompiledShader {
+    std::vector<u32> code;
+    Info info;
+};
+
+/**
+ * @brief Compiles batches of shaders to SPIR-V on a work-stealing thread pool, every worker owns
+ * the compilation arena used during translation and resets it between jobs so the allocations are
+ * reused across the entire batch
+ * @note Every shader is translated on its own with default bindings, VertexA programs which need
+ * to be merged with their VertexB counterpart should use the single-shader entry points
+ */
+class BatchCompiler {
+public:
+    /// Invoked on a worker thread once a shader finishes, the exception is set if it failed
+    using CompletionCallback =
+        std::function<void(size_t index, std::exception_ptr exception, CompiledShader shader)>;
+
+    /**
+     * @param num_workers The amount of worker threads, zero selects the amount of hardware threads
+     */
+    explicit BatchCompiler(size_t num_workers = 0);
+    ~BatchCompiler();
+
+    BatchCompiler(const BatchCompiler&) = delete;
+    BatchCompiler& operator=(const BatchCompiler&) = delete;
+
+    /**
+     * @brief Queues the compilation of every environment, the environments must remain valid until
+     * their compilation finishes while all other arguments are copied
+     * @return A future for every environment in the same order, it rethrows compilation errors
+     */
+    [[nodiscard]] std::vector<std::future<CompiledShader>> Compile(
+        std::span<Environment* const> envs, const Profile& profile, const RuntimeInfo& runtime_info,
+        const HostTranslateInfo& host_info, const CompileOptions& options);
+
+    /**
+     * @brief Queues the compilation of every environment with a callback invoked on completion
+     * @note The callback may be called concurrently from multiple workers
+     * @note Exceptions thrown by the callback are logged and otherwise ignored
+     */
+    void Compile(std::span<Environment* const> envs, const Profile& profile,
+                 const RuntimeInfo& runtime_info, const HostTranslateInfo& host_info,
+                 const CompileOptions& options, CompletionCallback callback);
+
+    /// Blocks until every queued compilation has finished
+    void WaitIdle();
+
+    [[nodiscard]] size_t NumWorkers() const noexcept {
+        return thread_pool.NumWorkers();
+    }
+
+private:
+    /// State owned by a single worker, it is only accessed by the thread with the same index
+    struct WorkerContext {
+        CompilationArena arena;
+    };
+
+    /// Arguments shared by every job of a batch
+    struct BatchState {
+        Profile profile;
+        RuntimeInfo runtime_info;
+        HostTranslateInfo host_info;
+        CompileOptions options;
+    };
+
+    [[nodiscard]] CompiledShader CompileShader(size_t worker_index, Environment& env,
+                                               const BatchState& state);
+
+    std::vector<std::unique_ptr<WorkerContext>> contexts;
+    WorkStealingThreadPool thread_pool; //!< Destroyed first so workers never outlive the contexts
+};
+
+} // namespace Shader
@@ -0,0 +1,125 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2026 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <algorithm>
+
+#include <shader_compiler/batch/thread_pool.h>
+
+namespace Shader {
+
+WorkStealingThreadPool::WorkStealingThreadPool(size_t num_workers) {
+    if (num_workers == 0) {
+        num_workers = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    }
+    queues.reserve(num_workers);
+    for (size_t index = 0; index < num_workers; ++index) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    threads.reserve(num_workers);
+    for (size_t index = 0; index < num_workers; ++index) {
+        threads.emplace_back(&WorkStealingThreadPool::WorkerMain, this, index);
+    }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    WaitIdle();
+    {
+        std::scoped_lock lock{mutex};
+        stopping = true;
+    }
+    work_cv.notify_all();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+void WorkStealingThreadPool::Submit(Task task) {
+    std::scoped_lock lock{mutex};
+    Queue& queue{*queues[next_queue]};
+    next_queue = (next_queue + 1) % queues.size();
+    {
+        std::scoped_lock queue_lock{queue.mutex};
+        queue.tasks.push_back(std::move(task));
+    }
+    ++num_queued;
+    ++num_pending;
+    work_cv.notify_one();
+}
+
+void WorkStealingThreadPool::Submit(std::vector<Task>&& tasks) {
+    if (tasks.empty()) {
+        return;
+    }
+    std::scoped_lock lock{mutex};
+    const size_t num_queues{queues.size()};
+    const size_t per_queue{tasks.size() / num_queues};
+    const size_t remainder{tasks.size() % num_queues};
+    auto it{tasks.begin()};
+    for (size_t offset = 0; offset < num_queues && it != tasks.end(); ++offset) {
+        // Contiguous runs keep related jobs on the same worker until they are stolen
+        const size_t count{per_queue + (offset < remainder ? 1 : 0)};
+        Queue& queue{*queues[(next_queue + offset) % num_queues]};
+        std::scoped_lock queue_lock{queue.mutex};
+        queue.tasks.insert(queue.tasks.end(), std::make_move_iterator(it),
+                           std::make_move_iterator(it + static_cast<ptrdiff_t>(count)));
+        it += static_cast<ptrdiff_t>(count);
+    }
+    next_queue = (next_queue + remainder) % num_queues;
+    num_queued += tasks.size();
+    num_pending += tasks.size();
+    tasks.clear();
+    work_cv.notify_all();
+}
+
+void WorkStealingThreadPool::WaitIdle() {
+    std::unique_lock lock{mutex};
+    idle_cv.wait(lock, [this] { return num_pending == 0; });
+}
+
+void WorkStealingThreadPool::WorkerMain(size_t worker_index) {
+    Task task;
+    while (true) {
+        if (!TryPop(worker_index, task)) {
+            std::unique_lock lock{mutex};
+            work_cv.wait(lock, [this] { return stopping || num_queued.load() != 0; });
+            if (stopping && num_queued.load() == 0) {
+                return;
+            }
+            continue;
+        }
+        task(worker_index);
+        task = nullptr;
+
+        std::scoped_lock lock{mutex};
+        if (--num_pending == 0) {
+            idle_cv.notify_all();
+        }
+    }
+}
+
+bool WorkStealingThreadPool::TryPop(size_t worker_index, Task& task) {
+    {
+        Queue& queue{*queues[worker_index]};
+        std::scoped_lock lock{queue.mutex};
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            --num_queued;
+            return true;
+        }
+    }
+    const size_t num_queues{queues.size()};
+    for (size_t offset = 1; offset < num_queues; ++offset) {
+        Queue& victim{*queues[(worker_index + offset) % num_queues]};
+        std::scoped_lock lock{victim.mutex};
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            --num_queued;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace Shader
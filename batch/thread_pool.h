@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2026 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <shader_compiler/common/common_types.h>
+
+namespace Shader {
+
+/**
+ * @brief A thread pool where every worker owns a task queue, idle workers steal the oldest tasks
+ * from the queues of other workers so uneven workloads are balanced without a central queue
+ * @note Tasks receive the index of the worker running them, this allows callers to keep state
+ * local to a worker without any synchronization
+ */
+class WorkStealingThreadPool {
+public:
+    /// A unit of work, it must not throw
+    using Task = std::function<void(size_t worker_index)>;
+
+    /**
+     * @param num_workers The amount of worker threads, zero selects the amount of hardware threads
+     */
+    explicit WorkStealingThreadPool(size_t num_workers = 0);
+
+    /// Waits for all submitted tasks to finish before joining the workers
+    ~WorkStealingThreadPool();
+
+    WorkStealingThreadPool(const WorkStealingThreadPool&) = delete;
+    WorkStealingThreadPool& operator=(const WorkStealingThreadPool&) = delete;
+
+    void Submit(Task task);
+
+    /// Distributes the tasks evenly across the queues of all workers and wakes them at once
+    void Submit(std::vector<Task>&& tasks);
+
+    /// Blocks until every submitted task has finished running
+    void WaitIdle();
+
+    [[nodiscard]] size_t NumWorkers() const noexcept {
+        return threads.size();
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void WorkerMain(size_t worker_index);
+
+    /// Pops the newest task of the worker's queue or steals the oldest task of another queue
+    [[nodiscard]] bool TryPop(size_t worker_index, Task& task);
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable work_cv;
+    std::condition_variable idle_cv;
+    std::atomic<size_t> num_queued{};
+    size_t num_pending{};
+    size_t next_queue{};
+    bool stopping{};
+};
+
+} // namespace Shader
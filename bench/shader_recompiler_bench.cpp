@@ -0,0 +1,733 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2026 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <new>
+#include <optional>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include <shader_compiler/backend/bindings.h>
+#include <shader_compiler/backend/glasm/emit_glasm.h>
+#include <shader_compiler/backend/glsl/emit_glsl.h>
+#include <shader_compiler/backend/spirv/emit_spirv.h>
+#include <shader_compiler/batch/thread_pool.h>
+#include <shader_compiler/cache/environment_snapshot.h>
+#include <shader_compiler/common/log.h>
+#include <shader_compiler/compilation_arena.h>
+#include <shader_compiler/compile_options.h>
+#include <shader_compiler/frontend/ir/basic_block.h>
+#include <shader_compiler/frontend/ir/program.h>
+#include <shader_compiler/frontend/maxwell/control_flow.h>
+#include <shader_compiler/frontend/maxwell/decode.h>
+#include <shader_compiler/frontend/maxwell/location.h>
+#include <shader_compiler/frontend/maxwell/structured_control_flow.h>
+#include <shader_compiler/frontend/maxwell/translate_program.h>
+#include <shader_compiler/host_translate_info.h>
+#include <shader_compiler/instrumentation.h>
+#include <shader_compiler/profile.h>
+#include <shader_compiler/runtime_info.h>
+
+namespace {
+std::atomic<size_t> num_allocated_bytes{};
+bool verbose_log{};
+} // Anonymous namespace
+
+void* operator new(size_t size) {
+    num_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* const pointer{std::malloc(size == 0 ? 1 : size)}) {
+        return pointer;
+    }
+    throw std::bad_alloc{};
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    num_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    const auto align{static_cast<size_t>(alignment)};
+    if (void* const pointer{std::aligned_alloc(align, (std::max<size_t>(size, 1) + align - 1) /
+                                                           align * align)}) {
+        return pointer;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+namespace Shader::Log {
+void Debug(const std::string& message) {
+    if (verbose_log) {
+        fmt::print(stderr, "{}\n", message);
+    }
+}
+
+void Warn(const std::string& message) {
+    if (verbose_log) {
+        fmt::print(stderr, "{}\n", message);
+    }
+}
+
+void Error(const std::string& message) {
+    if (verbose_log) {
+        fmt::print(stderr, "{}\n", message);
+    }
+}
+} // namespace Shader::Log
+
+namespace Shader {
+namespace {
+using Clock = std::chrono::steady_clock;
+
+enum class Phase : size_t {
+    CFG,
+    Translate,
+    EmitSPIRV,
+    EmitGLSL,
+    EmitGLASM,
+};
+constexpr size_t NUM_PHASES{5};
+constexpr std::array<std::string_view, NUM_PHASES> PHASE_NAMES{
+    "CFG", "TranslateProgram", "EmitSPIRV", "EmitGLSL", "EmitGLASM",
+};
+
+struct PhaseStats {
+    std::vector<double> samples; //!< Wall time of every run in microseconds
+    size_t allocated_bytes{};
+};
+
+struct Options {
+    std::filesystem::path directory;
+    size_t iterations{1};
+    std::vector<Phase> backends{Phase::EmitSPIRV, Phase::EmitGLSL, Phase::EmitGLASM};
+    bool pass_report{};
+    bool decode_report{};
+    size_t goto_stress{}; //!< Largest amount of branches in the synthetic goto stress test
+    size_t translation_threads{}; //!< Workers translating the blocks of large shaders
+};
+
+/// Statistics of a pass accumulated over every shader
+struct PassTotals {
+    std::string_view name;
+    size_t runs{};
+    std::chrono::nanoseconds duration{};
+    size_t visited_insts{};
+    size_t created_insts{};
+    size_t removed_insts{};
+};
+
+/// Runs the function, adding its wall time and allocations to the stats when they are supplied
+template <typename Func>
+double Measure(PhaseStats* stats, Func&& func) {
+    const size_t bytes_before{num_allocated_bytes.load(std::memory_order_relaxed)};
+    const Clock::time_point start{Clock::now()};
+    func();
+    const Clock::time_point end{Clock::now()};
+    const double micros{std::chrono::duration<double, std::micro>(end - start).count()};
+    if (stats) {
+        stats->samples.push_back(micros);
+        const size_t bytes_after{num_allocated_bytes.load(std::memory_order_relaxed)};
+        stats->allocated_bytes += bytes_after - bytes_before;
+    }
+    return micros;
+}
+
+/// Nearest-rank percentile of the samples
+double Percentile(std::vector<double> samples, double percentile) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    std::ranges::sort(samples);
+    const double size{static_cast<double>(samples.size())};
+    const auto rank{static_cast<size_t>(std::ceil(percentile * size))};
+    return samples[std::clamp<size_t>(rank, 1, samples.size()) - 1];
+}
+
+/// Adds the passes of a shader to the totals, keeping passes in the order they first ran
+void AccumulatePasses(std::vector<PassTotals>& totals, InstrumentationReport& report) {
+    for (const PassStatistics& pass : report.Passes()) {
+        auto it{std::ranges::find(totals, pass.name, &PassTotals::name)};
+        if (it == totals.end()) {
+            it = totals.insert(it, PassTotals{.name = pass.name});
+        }
+        ++it->runs;
+        it->duration += pass.duration;
+        it->visited_insts += pass.visited_insts;
+        it->created_insts += pass.created_insts;
+        it->removed_insts += pass.removed_insts;
+    }
+    report.Clear();
+}
+
+/**
+ * @brief A compute shader made of deeply nested conditionals and loops, with branches from
+ * nested statements back to the start of enclosing loops
+ * @note Every block ends in a branch which the structurizer has to eliminate, the backward
+ * branches out of nested statements have to be moved outwards through every level in between,
+ * which is quadratic in the nesting depth when levels are recomputed on every movement.
+ * The statements are entered through an indirect branch placed after a data word, which the
+ * table tracker has to skip while scanning the program up to the branch
+ */
+class GotoStressEnvironment final : public Environment {
+public:
+    explicit GotoStressEnvironment(size_t num_branches_) : num_branches{num_branches_} {
+        stage = Stage::Compute;
+        start_address = 0;
+        EmitIndirectEntry();
+        while (branch_count < num_branches) {
+            EmitRegion(0);
+        }
+        Emit(EXIT);
+    }
+
+    u64 ReadInstruction(u32 address) override {
+        return code.at(address / sizeof(u64));
+    }
+
+    std::span<const u64> CodeView(u32 address, u32 size) override {
+        const size_t first{address / sizeof(u64)};
+        if (address % sizeof(u64) != 0 || first >= code.size()) {
+            return {};
+        }
+        return std::span{code}.subspan(first,
+                                       std::min<size_t>(size / sizeof(u64), code.size() - first));
+    }
+
+    u32 ReadCbufValue(u32, u32) override {
+        return 0;
+    }
+
+    TextureType ReadTextureType(u32) override {
+        return TextureType::Color2D;
+    }
+
+    TexturePixelFormat ReadTexturePixelFormat(u32) override {
+        return TexturePixelFormat::OTHER;
+    }
+
+    u32 ReadViewportTransformState() override {
+        return 0;
+    }
+
+    u32 TextureBoundBuffer() const override {
+        return 0;
+    }
+
+    u32 LocalMemorySize() const override {
+        return 0;
+    }
+
+    u32 SharedMemorySize() const override {
+        return 0;
+    }
+
+    std::array<u32, 3> WorkgroupSize() const override {
+        return {32, 1, 1};
+    }
+
+    bool HasHLEMacroState() const override {
+        return false;
+    }
+
+    std::optional<ReplaceConstant> GetReplaceConstBuffer(u32, u32) override {
+        return std::nullopt;
+    }
+
+    void Dump(u64) override {}
+
+    [[nodiscard]] size_t NumBranches() const noexcept {
+        return branch_count;
+    }
+
+    [[nodiscard]] size_t MaxDepth() const noexcept {
+        return max_depth;
+    }
+
+private:
+    static constexpr u64 PRED_TRUE{7ULL << 16};
+    static constexpr u64 PRED_P0{0ULL << 16};
+    static constexpr u64 FLOW_TEST_T{15};
+    static constexpr u64 NOP{0x50b0000000000000ULL | PRED_TRUE};
+    static constexpr u64 EXIT{0xe300000000000000ULL | PRED_TRUE | FLOW_TEST_T};
+    static constexpr u64 BRA{0xe240000000000000ULL | FLOW_TEST_T};
+    static constexpr u64 BRX{0xe250000000000000ULL | PRED_TRUE | FLOW_TEST_T};
+    static constexpr u64 LDC_B32{0xef94000000000000ULL | PRED_TRUE};
+    static constexpr u64 SHL_IMM{0x3848000000000000ULL | PRED_TRUE};
+    static constexpr u64 IMNMX_IMM{0x3820000000000000ULL | PRED_TRUE | (7ULL << 39)};
+    static constexpr u64 DATA_WORD{0x000000003f800000ULL}; //!< 1.0f, no encoding matches it
+
+    void Emit(u64 insn) {
+        const size_t index{pc.Offset() / sizeof(u64)};
+        code.resize(index + 1);
+        code[index] = insn;
+        ++pc;
+    }
+
+    /// Encodes a branch conditional on P0 at a location to the target
+    [[nodiscard]] static u64 Branch(Maxwell::Location location, Maxwell::Location target) {
+        const u32 offset{target.Offset() - location.Offset() - 8};
+        return BRA | PRED_P0 | (static_cast<u64>(offset & 0xffffff) << 20);
+    }
+
+    void EmitBranch(Maxwell::Location target) {
+        Emit(Branch(pc, target));
+        ++branch_count;
+    }
+
+    /**
+     * @brief Branches over a data word into a single entry table of R0, the entry is read as zero
+     * which makes the indirect branch continue to the following instruction
+     */
+    void EmitIndirectEntry() {
+        Emit(BRA | PRED_TRUE | (8ULL << 20));
+        Emit(DATA_WORD);
+        Emit(IMNMX_IMM);
+        Emit(SHL_IMM | (2ULL << 20));
+        Emit(LDC_B32);
+        Emit(BRX);
+    }
+
+    /**
+     * @brief Emits statements until enough branches were emitted, nested statements only end with
+     * a small probability so most of the program sits hundreds of levels deep
+     */
+    void EmitRegion(size_t depth) {
+        constexpr size_t MAX_DEPTH{256};
+        max_depth = std::max(max_depth, depth);
+        while (branch_count < num_branches) {
+            switch (rng() % 16) {
+            case 0:
+                if (depth > 0) {
+                    return;
+                }
+                Emit(NOP);
+                break;
+            case 1:
+            case 2:
+            case 3:
+            case 4: {
+                if (depth == MAX_DEPTH) {
+                    break;
+                }
+                // Conditional, the branch skips the nested region and is patched afterwards
+                const Maxwell::Location branch_pc{pc};
+                EmitBranch(pc);
+                EmitRegion(depth + 1);
+                code[branch_pc.Offset() / sizeof(u64)] = Branch(branch_pc, pc);
+                break;
+            }
+            case 5:
+            case 6:
+            case 7:
+                if (depth == MAX_DEPTH) {
+                    break;
+                }
+                // Loop closed by a backward branch to its start
+                loop_begins.push_back(pc);
+                Emit(NOP);
+                EmitRegion(depth + 1);
+                EmitBranch(loop_begins.back());
+                loop_begins.pop_back();
+                break;
+            case 8:
+            case 9:
+                if (!loop_begins.empty()) {
+                    // Continue any enclosing loop, the branch has to be moved out through every
+                    // level nested in it
+                    EmitBranch(loop_begins[rng() % loop_begins.size()]);
+                    break;
+                }
+                Emit(NOP);
+                break;
+            default:
+                Emit(NOP);
+                break;
+            }
+        }
+    }
+
+    size_t num_branches;
+    size_t branch_count{};
+    size_t max_depth{};
+    std::vector<u64> code;
+    std::vector<Maxwell::Location> loop_begins;
+    Maxwell::Location pc{0};
+    std::minstd_rand rng{1};
+};
+
+/**
+ * @brief Builds the abstract syntax list of synthetic goto heavy shaders of increasing size, the
+ * time per branch stays flat when the structurizer scales linearly
+ */
+void BenchmarkGotoStress(size_t max_branches, size_t iterations,
+                         WorkStealingThreadPool* translation_pool) {
+    const HostTranslateInfo host_info{};
+    const CompileOptions options{
+        .translation_pool = translation_pool,
+    };
+    CompilationArena arena;
+    fmt::print("{:>10} {:>10} {:>6} {:>12} {:>14} {:>14}\n", "branches", "blocks", "depth",
+               "CFG (ms)", "BuildASL (ms)", "ns/branch");
+    for (size_t num_branches = std::min<size_t>(1024, max_branches);;
+         num_branches = std::min(num_branches * 2, max_branches)) {
+        GotoStressEnvironment env{num_branches};
+        std::vector<double> cfg_samples;
+        std::vector<double> asl_samples;
+        size_t num_blocks{};
+        for (size_t iteration = 0; iteration < iterations; ++iteration) {
+            std::optional<Maxwell::Flow::CFG> cfg;
+            cfg_samples.push_back(Measure(nullptr, [&] {
+                cfg.emplace(env, arena.FlowBlockPool(), env.StartAddress());
+            }));
+            num_blocks = cfg->Functions().front().blocks.size();
+            asl_samples.push_back(Measure(nullptr, [&] {
+                static_cast<void>(Maxwell::BuildASL(arena, env, *cfg, host_info, options));
+            }));
+            cfg.reset();
+            arena.Reset();
+        }
+        const double asl_time{Percentile(asl_samples, 0.50)};
+        fmt::print("{:>10} {:>10} {:>6} {:>12.3f} {:>14.3f} {:>14.1f}\n", env.NumBranches(),
+                   num_blocks, env.MaxDepth(), Percentile(cfg_samples, 0.50) / 1000.0,
+                   asl_time / 1000.0, asl_time * 1000.0 / static_cast<double>(env.NumBranches()));
+        if (num_branches == max_branches) {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Compares decoding the instructions of every shader one at a time against decoding them
+ * as a single stream, the instructions are repeated to get a stream much larger than any shader
+ */
+void BenchmarkDecode(std::span<const std::unique_ptr<ReplayEnvironment>> envs,
+                     CompilationArena& arena, size_t iterations) {
+    constexpr size_t MIN_STREAM_SIZE{1 << 20};
+    std::vector<u64> shader_insns;
+    for (const auto& env : envs) {
+        try {
+            Maxwell::Flow::CFG cfg{*env, arena.FlowBlockPool(), env->StartAddress()};
+            for (const Maxwell::Flow::Function& function : cfg.Functions()) {
+                for (const Maxwell::Flow::Block& block : function.blocks) {
+                    if (block.begin.IsVirtual()) {
+                        continue;
+                    }
+                    for (Maxwell::Location pc = block.begin; pc != block.end; ++pc) {
+                        shader_insns.push_back(cfg.Instructions().Fetch(pc).raw);
+                    }
+                }
+            }
+        } catch (const std::exception&) {
+        }
+        arena.Reset();
+    }
+    if (shader_insns.empty()) {
+        return;
+    }
+    std::vector<u64> insns;
+    insns.reserve(MIN_STREAM_SIZE + shader_insns.size());
+    while (insns.size() < MIN_STREAM_SIZE) {
+        insns.insert(insns.end(), shader_insns.begin(), shader_insns.end());
+    }
+    std::vector<Maxwell::Opcode> opcodes(insns.size());
+    const double scalar_time{Measure(nullptr, [&] {
+        for (size_t iteration = 0; iteration < iterations; ++iteration) {
+            for (size_t index = 0; index < insns.size(); ++index) {
+                opcodes[index] = Maxwell::Decode(insns[index]);
+            }
+        }
+    })};
+    const double batch_time{Measure(nullptr, [&] {
+        for (size_t iteration = 0; iteration < iterations; ++iteration) {
+            static_cast<void>(Maxwell::DecodeMany(insns, opcodes));
+        }
+    })};
+    const double num_decoded{static_cast<double>(insns.size() * iterations)};
+    fmt::print("\ndecode: {} instructions x {} iteration(s)\n", insns.size(), iterations);
+    fmt::print("Decode: {:.2f} ns/inst, DecodeMany: {:.2f} ns/inst ({:.2f}x)\n",
+               scalar_time * 1000.0 / num_decoded, batch_time * 1000.0 / num_decoded,
+               batch_time > 0.0 ? scalar_time / batch_time : 0.0);
+}
+
+std::optional<Options> ParseOptions(int argc, char** argv) {
+    Options options;
+    for (int index = 1; index < argc; ++index) {
+        const std::string_view arg{argv[index]};
+        if (arg == "--iterations" && index + 1 < argc) {
+            options.iterations = std::strtoull(argv[++index], nullptr, 10);
+        } else if (arg == "--backends" && index + 1 < argc) {
+            options.backends.clear();
+            std::string_view list{argv[++index]};
+            while (!list.empty()) {
+                const size_t comma{std::min(list.find(','), list.size())};
+                const std::string_view name{list.substr(0, comma)};
+                if (name == "spirv") {
+                    options.backends.push_back(Phase::EmitSPIRV);
+                } else if (name == "glsl") {
+                    options.backends.push_back(Phase::EmitGLSL);
+                } else if (name == "glasm") {
+                    options.backends.push_back(Phase::EmitGLASM);
+                } else {
+                    fmt::print(stderr, "Unknown backend '{}'\n", name);
+                    return std::nullopt;
+                }
+                list.remove_prefix(std::min(comma + 1, list.size()));
+            }
+        } else if (arg == "--passes") {
+            options.pass_report = true;
+        } else if (arg == "--goto-stress" && index + 1 < argc) {
+            options.goto_stress = std::strtoull(argv[++index], nullptr, 10);
+        } else if (arg == "--translation-threads" && index + 1 < argc) {
+            options.translation_threads = std::strtoull(argv[++index], nullptr, 10);
+        } else if (arg == "--decode") {
+            options.decode_report = true;
+        } else if (arg == "--verbose") {
+            verbose_log = true;
+        } else if (options.directory.empty() && !arg.starts_with("--")) {
+            options.directory = arg;
+        } else {
+            return std::nullopt;
+        }
+    }
+    if ((options.directory.empty() && options.goto_stress == 0) || options.iterations == 0 ||
+        options.backends.empty()) {
+        return std::nullopt;
+    }
+    return options;
+}
+
+/**
+ * @brief Runs a directory of environment snapshots through CFG construction, translation and every
+ * selected backend, reporting the wall time and the amount of bytes allocated by each phase
+ * @note Snapshots are captured with WriteEnvironmentSnapshot, every regular file in the directory
+ * is expected to be one
+ */
+int Run(const Options& options) {
+    std::optional<WorkStealingThreadPool> translation_pool;
+    if (options.translation_threads != 0) {
+        translation_pool.emplace(options.translation_threads);
+    }
+    WorkStealingThreadPool* const translation_pool_ptr{translation_pool ? &*translation_pool
+                                                                        : nullptr};
+    if (options.directory.empty()) {
+        BenchmarkGotoStress(options.goto_stress, options.iterations, translation_pool_ptr);
+        return EXIT_SUCCESS;
+    }
+    std::vector<std::filesystem::path> paths;
+    for (const auto& entry : std::filesystem::directory_iterator{options.directory}) {
+        if (entry.is_regular_file()) {
+            paths.push_back(entry.path());
+        }
+    }
+    std::ranges::sort(paths);
+    std::vector<std::unique_ptr<ReplayEnvironment>> envs;
+    envs.reserve(paths.size());
+    for (const auto& path : paths) {
+        envs.push_back(std::make_unique<ReplayEnvironment>(path));
+    }
+    if (envs.empty()) {
+        fmt::print(stderr, "No snapshots in {}\n", options.directory.string());
+        return EXIT_FAILURE;
+    }
+
+    const Profile profile{
+        .supported_spirv = 0x00010300,
+        .unified_descriptor_binding = true,
+        .support_int8 = true,
+        .support_int16 = true,
+        .support_int64 = true,
+        .support_vertex_instance_id = true,
+        .support_float_controls = true,
+        .support_vote = true,
+        .support_demote_to_helper_invocation = true,
+        .support_derivative_control = true,
+        .warp_size_potentially_larger_than_guest = true,
+        .max_subgroup_size = 32,
+    };
+    const RuntimeInfo runtime_info{};
+    const HostTranslateInfo host_info{
+        .support_float16 = true,
+        .support_int64 = true,
+        .min_ssbo_alignment = 16,
+    };
+    const CompileOptions compile_options{
+        .translation_pool = translation_pool_ptr,
+    };
+    InstrumentationReport report;
+    const CompileOptions instrumented_options{
+        .instrumentation = options.pass_report ? &report : nullptr,
+        .translation_pool = translation_pool_ptr,
+    };
+    std::vector<PassTotals> pass_totals;
+
+    CompilationArena arena;
+    std::array<PhaseStats, NUM_PHASES> stats{};
+    std::vector<double> latencies;
+    size_t num_failures{};
+    const size_t bytes_before{num_allocated_bytes.load(std::memory_order_relaxed)};
+
+    for (size_t iteration = 0; iteration < options.iterations; ++iteration) {
+        for (size_t index = 0; index < envs.size(); ++index) {
+            Environment& env{*envs[index]};
+            double latency{};
+            try {
+                // Every backend mutates the program so each one gets a fresh translation, only the
+                // first one is measured and its emission is counted towards the shader latency
+                for (size_t backend = 0; backend < options.backends.size(); ++backend) {
+                    const bool is_primary{backend == 0};
+                    const auto phase_stats{[&](Phase phase) {
+                        return is_primary ? &stats[static_cast<size_t>(phase)] : nullptr;
+                    }};
+                    const CompileOptions& backend_options{is_primary ? instrumented_options
+                                                                     : compile_options};
+                    std::optional<Maxwell::Flow::CFG> cfg;
+                    std::optional<IR::Program> program;
+                    const double cfg_time{Measure(phase_stats(Phase::CFG), [&] {
+                        const PassScope scope{backend_options.instrumentation, "CFG"};
+                        cfg.emplace(env, arena.FlowBlockPool(), env.StartAddress());
+                    })};
+                    const double translate_time{Measure(phase_stats(Phase::Translate), [&] {
+                        program = Maxwell::TranslateProgram(arena, env, *cfg, host_info,
+                                                            backend_options);
+                    })};
+                    const Phase phase{options.backends[backend]};
+                    const double emit_time{
+                        Measure(&stats[static_cast<size_t>(phase)], [&] {
+                            Backend::Bindings bindings;
+                            switch (phase) {
+                            case Phase::EmitSPIRV:
+                                static_cast<void>(Backend::SPIRV::EmitSPIRV(
+                                    profile, runtime_info, *program, bindings, backend_options));
+                                break;
+                            case Phase::EmitGLSL:
+                                static_cast<void>(Backend::GLSL::EmitGLSL(
+                                    profile, runtime_info, *program, bindings, backend_options));
+                                break;
+                            case Phase::EmitGLASM:
+                                static_cast<void>(Backend::GLASM::EmitGLASM(
+                                    profile, runtime_info, *program, bindings, backend_options));
+                                break;
+                            default:
+                                break;
+                            }
+                        })};
+                    if (is_primary) {
+                        latency = cfg_time + translate_time + emit_time;
+                    }
+                    program.reset();
+                    cfg.reset();
+                    arena.Reset();
+                }
+                latencies.push_back(latency);
+                AccumulatePasses(pass_totals, report);
+            } catch (const std::exception& exception) {
+                arena.Reset();
+                report.Clear();
+                ++num_failures;
+                if (verbose_log) {
+                    fmt::print(stderr, "{}: {}\n", paths[index].filename().string(),
+                               exception.what());
+                }
+            }
+        }
+    }
+    const size_t total_bytes{num_allocated_bytes.load(std::memory_order_relaxed) - bytes_before};
+
+    fmt::print("{:<18} {:>6} {:>12} {:>10} {:>10} {:>14}\n", "phase", "runs", "total (ms)",
+               "p50 (us)", "p99 (us)", "allocated (KiB)");
+    for (size_t phase = 0; phase < NUM_PHASES; ++phase) {
+        const PhaseStats& phase_stats{stats[phase]};
+        if (phase_stats.samples.empty()) {
+            continue;
+        }
+        double total{};
+        for (const double sample : phase_stats.samples) {
+            total += sample;
+        }
+        fmt::print("{:<18} {:>6} {:>12.3f} {:>10.1f} {:>10.1f} {:>14.1f}\n", PHASE_NAMES[phase],
+                   phase_stats.samples.size(), total / 1000.0,
+                   Percentile(phase_stats.samples, 0.50), Percentile(phase_stats.samples, 0.99),
+                   static_cast<double>(phase_stats.allocated_bytes) / 1024.0);
+    }
+    if (!pass_totals.empty()) {
+        fmt::print("\n{:<32} {:>6} {:>12} {:>12} {:>12} {:>12}\n", "pass", "runs", "total (ms)",
+                   "visited", "created", "removed");
+        for (const PassTotals& pass : pass_totals) {
+            fmt::print("{:<32} {:>6} {:>12.3f} {:>12} {:>12} {:>12}\n", pass.name, pass.runs,
+                       std::chrono::duration<double, std::milli>(pass.duration).count(),
+                       pass.visited_insts, pass.created_insts, pass.removed_insts);
+        }
+        fmt::print("IR layout: {} bytes per instruction, {} bytes per value\n", sizeof(IR::Inst),
+                   sizeof(IR::Value));
+    }
+    double total_latency{};
+    for (const double latency : latencies) {
+        total_latency += latency;
+    }
+    fmt::print("\nshaders: {} ({} failed) over {} iteration(s)\n", envs.size(), num_failures,
+               options.iterations);
+    fmt::print("shaders/s: {:.1f}\n",
+               total_latency > 0.0 ? static_cast<double>(latencies.size()) * 1e6 / total_latency
+                                   : 0.0);
+    fmt::print("latency ({}): p50 {:.1f} us, p99 {:.1f} us\n",
+               PHASE_NAMES[static_cast<size_t>(options.backends.front())],
+               Percentile(latencies, 0.50), Percentile(latencies, 0.99));
+    fmt::print("allocated: {:.1f} KiB total, {:.1f} KiB per shader\n",
+               static_cast<double>(total_bytes) / 1024.0,
+               static_cast<double>(total_bytes) / 1024.0 /
+                   static_cast<double>(envs.size() * options.iterations));
+    fmt::print("arena high-water mark: {:.1f} KiB\n",
+               static_cast<double>(arena.HighWaterMark()) / 1024.0);
+    if (options.decode_report) {
+        BenchmarkDecode(envs, arena, options.iterations);
+    }
+    if (options.goto_stress != 0) {
+        fmt::print("\n");
+        BenchmarkGotoStress(options.goto_stress, options.iterations, translation_pool_ptr);
+    }
+    return num_failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+} // Anonymous namespace
+} // namespace Shader
+
+int main(int argc, char** argv) {
+    const std::optional<Shader::Options> options{Shader::ParseOptions(argc, argv)};
+    if (!options) {
+        fmt::print(stderr, "Usage: {} [<snapshot directory>] [--iterations N] "
+                           "[--backends spirv,glsl,glasm] [--passes] [--decode] [--goto-stress N] "
+                           "[--translation-threads N] [--verbose]\n",
+                   argv[0]);
+        return EXIT_FAILURE;
+    }
+    try {
+        return Shader::Run(*options);
+    } catch (const std::exception& exception) {
+        fmt::print(stderr, "{}\n", exception.what());
+        return EXIT_FAILURE;
+    }
+}
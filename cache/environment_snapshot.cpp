@@ -0,0 +1,271 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2026 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+#include <shader_compiler/cache/environment_snapshot.h>
+#include <shader_compiler/cache/serialization.h>
+#include <shader_compiler/exception.h>
+
+namespace Shader {
+namespace {
+constexpr u64 SNAPSHOT_MAGIC{0x50414E53454E4853ULL}; // "SHNESNAP"
+constexpr u32 SNAPSHOT_FORMAT_VERSION{1};
+
+static_assert(std::is_trivially_copyable_v<ProgramHeader>);
+
+struct SnapshotHeader {
+    u64 magic;
+    u32 format_version;
+    u32 stage;
+    u32 start_address;
+    u32 is_propietary_driver;
+    std::array<u8, sizeof(ProgramHeader)> sph;
+    std::array<u32, 8> gp_passthrough_mask;
+    u32 code_begin;
+    u32 num_code_words;
+    u32 texture_bound_buffer;
+    u32 local_memory_size;
+    u32 shared_memory_size;
+    std::array<u32, 3> workgroup_size;
+    u32 has_hle_macro_state;
+    u32 has_viewport_transform_state;
+    u32 viewport_transform_state;
+    u32 num_cbuf_values;
+    u32 num_texture_types;
+    u32 num_texture_pixel_formats;
+    u32 num_replace_const_buffers;
+    u32 padding;
+};
+// Instruction words directly follow the header and are served in place from the mapping
+static_assert(sizeof(SnapshotHeader) % alignof(u64) == 0);
+
+/// Missing replacements are encoded with the all ones value
+constexpr u32 NO_REPLACEMENT{~0U};
+} // Anonymous namespace
+
+std::vector<u8> SerializeEnvironmentSnapshot(RecordingEnvironment& env) {
+    const EnvironmentQueries queries{env.Queries()};
+    const u32 code_size{queries.code_end - queries.code_begin};
+    const u32 num_code_words{code_size / static_cast<u32>(sizeof(u64)) + 1};
+    SnapshotHeader header{
+        .magic = SNAPSHOT_MAGIC,
+        .format_version = SNAPSHOT_FORMAT_VERSION,
+        .stage = static_cast<u32>(env.ShaderStage()),
+        .start_address = env.StartAddress(),
+        .is_propietary_driver = env.IsPropietaryDriver() ? 1U : 0U,
+        .sph{},
+        .gp_passthrough_mask = env.GpPassthroughMask(),
+        .code_begin = queries.code_begin,
+        .num_code_words = num_code_words,
+        .texture_bound_buffer = queries.texture_bound_buffer,
+        .local_memory_size = queries.local_memory_size,
+        .shared_memory_size = queries.shared_memory_size,
+        .workgroup_size = queries.workgroup_size,
+        .has_hle_macro_state = queries.has_hle_macro_state ? 1U : 0U,
+        .has_viewport_transform_state = queries.viewport_transform_state ? 1U : 0U,
+        .viewport_transform_state = queries.viewport_transform_state.value_or(0),
+        .num_cbuf_values = static_cast<u32>(queries.cbuf_values.size()),
+        .num_texture_types = static_cast<u32>(queries.texture_types.size()),
+        .num_texture_pixel_formats = static_cast<u32>(queries.texture_pixel_formats.size()),
+        .num_replace_const_buffers = static_cast<u32>(queries.replace_const_buffers.size()),
+        .padding = 0,
+    };
+    std::memcpy(header.sph.data(), &env.SPH(), sizeof(ProgramHeader));
+
+    BinaryWriter writer;
+    writer.Write(header);
+    for (u32 word = 0; word < num_code_words; ++word) {
+        const u32 address{queries.code_begin + word * static_cast<u32>(sizeof(u64))};
+        writer.Write(env.ReadInstruction(address));
+    }
+    // Maps are ordered, this keeps every array sorted by key for lookups during replay
+    for (const auto& [key, value] : queries.cbuf_values) {
+        writer.Write(SnapshotKeyValue{key.first, key.second, value});
+    }
+    for (const auto& [handle, type] : queries.texture_types) {
+        writer.Write(SnapshotKeyValue{handle, 0, static_cast<u32>(type)});
+    }
+    for (const auto& [handle, format] : queries.texture_pixel_formats) {
+        writer.Write(SnapshotKeyValue{handle, 0, static_cast<u32>(format)});
+    }
+    for (const auto& [key, replacement] : queries.replace_const_buffers) {
+        const u32 value{replacement ? static_cast<u32>(*replacement) : NO_REPLACEMENT};
+        writer.Write(SnapshotKeyValue{key.first, key.second, value});
+    }
+    return std::move(writer.data);
+}
+
+void WriteEnvironmentSnapshot(const std::filesystem::path& path, RecordingEnvironment& env) {
+    const std::vector<u8> data{SerializeEnvironmentSnapshot(env)};
+    File file{path, File::Mode::Write};
+    if (!file.IsOpen()) {
+        throw RuntimeError("Failed to open environment snapshot {}", path.string());
+    }
+    if (!file.Write(data)) {
+        throw RuntimeError("Failed to write environment snapshot {}", path.string());
+    }
+}
+
+ReplayEnvironment::ReplayEnvironment(const std::filesystem::path& path) {
+    const File file{path, File::Mode::Read};
+    if (!file.IsOpen()) {
+        throw RuntimeError("Failed to open environment snapshot {}", path.string());
+    }
+    const std::optional<size_t> file_size{file.Size()};
+    if (!file_size || *file_size == 0) {
+        throw RuntimeError("Failed to stat environment snapshot {}", path.string());
+    }
+    std::optional<FileView> view{file.View(*file_size)};
+    if (!view) {
+        throw RuntimeError("Failed to map environment snapshot {}", path.string());
+    }
+    mapping = std::move(*view);
+    snapshot = mapping.Data();
+    Parse();
+}
+
+ReplayEnvironment::ReplayEnvironment(std::span<const u8> snapshot_) : snapshot{snapshot_} {
+    if (reinterpret_cast<uintptr_t>(snapshot.data()) % alignof(u64) != 0) {
+        throw InvalidArgument("Environment snapshot is not aligned to {} bytes", alignof(u64));
+    }
+    Parse();
+}
+
+ReplayEnvironment::~ReplayEnvironment() = default;
+
+void ReplayEnvironment::Parse() {
+    BinaryReader reader{snapshot};
+    const std::optional<SnapshotHeader> header{reader.Read<SnapshotHeader>()};
+    if (!header || header->magic != SNAPSHOT_MAGIC ||
+        header->format_version != SNAPSHOT_FORMAT_VERSION) {
+        throw RuntimeError("Invalid environment snapshot");
+    }
+    const auto read_array{[&]<typename T>(std::span<const T>& result, size_t count) {
+        const size_t offset{reader.Offset()};
+        if (!reader.Read(count * sizeof(T))) {
+            throw RuntimeError("Truncated environment snapshot");
+        }
+        result = std::span(reinterpret_cast<const T*>(snapshot.data() + offset), count);
+    }};
+    read_array(code, header->num_code_words);
+    read_array(cbuf_values, header->num_cbuf_values);
+    read_array(texture_types, header->num_texture_types);
+    read_array(texture_pixel_formats, header->num_texture_pixel_formats);
+    read_array(replace_const_buffers, header->num_replace_const_buffers);
+
+    std::memcpy(&sph, header->sph.data(), sizeof(ProgramHeader));
+    gp_passthrough_mask = header->gp_passthrough_mask;
+    stage = static_cast<Stage>(header->stage);
+    start_address = header->start_address;
+    is_propietary_driver = header->is_propietary_driver != 0;
+
+    code_begin = header->code_begin;
+    texture_bound_buffer = header->texture_bound_buffer;
+    local_memory_size = header->local_memory_size;
+    shared_memory_size = header->shared_memory_size;
+    workgroup_size = header->workgroup_size;
+    has_hle_macro_state = header->has_hle_macro_state != 0;
+    if (header->has_viewport_transform_state != 0) {
+        viewport_transform_state = header->viewport_transform_state;
+    }
+}
+
+const SnapshotKeyValue* ReplayEnvironment::Find(std::span<const SnapshotKeyValue> key_values,
+                                                u32 key_a, u32 key_b) {
+    const auto it{std::ranges::lower_bound(key_values, std::pair{key_a, key_b}, {},
+                                           [](const SnapshotKeyValue& kv) {
+                                               return std::pair{kv.key_a, kv.key_b};
+                                           })};
+    if (it == key_values.end() || it->key_a != key_a || it->key_b != key_b) {
+        return nullptr;
+    }
+    return &*it;
+}
+
+u64 ReplayEnvironment::ReadInstruction(u32 address) {
+    if (address < code_begin || (address - code_begin) % sizeof(u64) != 0 ||
+        (address - code_begin) / sizeof(u64) >= code.size()) {
+        throw LogicError("Out of bounds address {}", address);
+    }
+    return code[(address - code_begin) / sizeof(u64)];
+}
+
+std::span<const u64> ReplayEnvironment::CodeView(u32 address, u32 size) {
+    if (address < code_begin || (address - code_begin) % sizeof(u64) != 0) {
+        return {};
+    }
+    const size_t first{(address - code_begin) / sizeof(u64)};
+    if (first >= code.size()) {
+        return {};
+    }
+    return code.subspan(first, std::min<size_t>(size / sizeof(u64), code.size() - first));
+}
+
+u32 ReplayEnvironment::ReadCbufValue(u32 cbuf_index, u32 cbuf_offset) {
+    const SnapshotKeyValue* const kv{Find(cbuf_values, cbuf_index, cbuf_offset)};
+    if (!kv) {
+        throw LogicError("Uncached read of cbuf {} offset {}", cbuf_index, cbuf_offset);
+    }
+    return kv->value;
+}
+
+TextureType ReplayEnvironment::ReadTextureType(u32 raw_handle) {
+    const SnapshotKeyValue* const kv{Find(texture_types, raw_handle, 0)};
+    if (!kv) {
+        throw LogicError("Uncached read texture type");
+    }
+    return static_cast<TextureType>(kv->value);
+}
+
+TexturePixelFormat ReplayEnvironment::ReadTexturePixelFormat(u32 raw_handle) {
+    const SnapshotKeyValue* const kv{Find(texture_pixel_formats, raw_handle, 0)};
+    if (!kv) {
+        throw LogicError("Uncached read texture pixel format");
+    }
+    return static_cast<TexturePixelFormat>(kv->value);
+}
+
+u32 ReplayEnvironment::ReadViewportTransformState() {
+    if (!viewport_transform_state) {
+        throw LogicError("Uncached read viewport transform state");
+    }
+    return *viewport_transform_state;
+}
+
+u32 ReplayEnvironment::TextureBoundBuffer() const {
+    return texture_bound_buffer;
+}
+
+u32 ReplayEnvironment::LocalMemorySize() const {
+    return local_memory_size;
+}
+
+u32 ReplayEnvironment::SharedMemorySize() const {
+    return shared_memory_size;
+}
+
+std::array<u32, 3> ReplayEnvironment::WorkgroupSize() const {
+    return workgroup_size;
+}
+
+bool ReplayEnvironment::HasHLEMacroState() const {
+    return has_hle_macro_state;
+}
+
+std::optional<ReplaceConstant> ReplayEnvironment::GetReplaceConstBuffer(u32 bank, u32 offset) {
+    const SnapshotKeyValue* const kv{Find(replace_const_buffers, bank, offset)};
+    if (!kv) {
+        throw LogicError("Uncached read of replacement for cbuf {} offset {}", bank, offset);
+    }
+    if (kv->value == NO_REPLACEMENT) {
+        return std::nullopt;
+    }
+    return static_cast<ReplaceConstant>(kv->value);
+}
+
+void ReplayEnvironment::Dump(u64) {}
+
+} // namespace Shader
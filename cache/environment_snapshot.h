@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2026 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <shader_compiler/cache/file.h>
+#include <shader_compiler/cache/recording_environment.h>
+#include <shader_compiler/common/common_types.h>
+#include <shader_compiler/environment.h>
+
+namespace Shader {
+
+/// A recorded query in an environment snapshot, arrays of these are sorted by their key
+struct SnapshotKeyValue {
+    u32 key_a;
+    u32 key_b;
+    u32 value;
+};
+
+/**
+ * @brief Serializes everything a translation read from an environment into a snapshot, this
+ * includes the instruction words and every query recorded by the environment
+ * @note The environment should have been used for a full translation beforehand so the snapshot
+ * contains all the data required to replay it
+ */
+[[nodiscard]] std::vector<u8> SerializeEnvironmentSnapshot(RecordingEnvironment& env);
+
+/// Serializes an environment snapshot and writes it to a file, replacing any existing file
+void WriteEnvironmentSnapshot(const std::filesystem::path& path, RecordingEnvironment& env);
+
+/**
+ * @brief Environment serving queries from a snapshot, this allows captured shaders to be
+ * translated deterministically outside of the emulator
+ * @note Instructions and queried values are read directly from a read-only view of the snapshot,
+ * which is memory mapped where supported, queries that weren't recorded throw a LogicError
+ */
+class ReplayEnvironment final : public Environment {
+public:
+    explicit ReplayEnvironment(const std::filesystem::path& path);
+
+    /// Replays a snapshot held in memory, the data must outlive the environment
+    explicit ReplayEnvironment(std::span<const u8> snapshot);
+
+    ~ReplayEnvironment() override;
+
+    ReplayEnvironment(const ReplayEnvironment&) = delete;
+    ReplayEnvironment& operator=(const ReplayEnvironment&) = delete;
+
+    [[nodiscard]] u64 ReadInstruction(u32 address) override;
+
+    [[nodiscard]] std::span<const u64> CodeView(u32 address, u32 size) override;
+
+    [[nodiscard]] u32 ReadCbufValue(u32 cbuf_index, u32 cbuf_offset) override;
+
+    [[nodiscard]] TextureType ReadTextureType(u32 raw_handle) override;
+
+    [[nodiscard]] TexturePixelFormat ReadTexturePixelFormat(u32 raw_handle) override;
+
+    [[nodiscard]] u32 ReadViewportTransformState() override;
+
+    [[nodiscard]] u32 TextureBoundBuffer() const override;
+
+    [[nodiscard]] u32 LocalMemorySize() const override;
+
+    [[nodiscard]] u32 SharedMemorySize() const override;
+
+    [[nodiscard]] std::array<u32, 3> WorkgroupSize() const override;
+
+    [[nodiscard]] bool HasHLEMacroState() const override;
+
+    [[nodiscard]] std::optional<ReplaceConstant> GetReplaceConstBuffer(u32 bank,
+                                                                       u32 offset) override;
+
+    void Dump(u64 hash) override;
+
+    /// The raw instruction words of the snapshot starting at CodeBegin
+    [[nodiscard]] std::span<const u64> Code() const noexcept {
+        return code;
+    }
+
+    [[nodiscard]] u32 CodeBegin() const noexcept {
+        return code_begin;
+    }
+
+    /// The size of the snapshot in bytes
+    [[nodiscard]] size_t SnapshotSize() const noexcept {
+        return snapshot.size();
+    }
+
+private:
+    void Parse();
+
+    [[nodiscard]] static const SnapshotKeyValue* Find(std::span<const SnapshotKeyValue> key_values,
+                                                      u32 key_a, u32 key_b);
+
+    std::span<const u8> snapshot;
+    FileView mapping;
+    std::span<const u64> code;
+    u32 code_begin{};
+    std::span<const SnapshotKeyValue> cbuf_values;
+    std::span<const SnapshotKeyValue> texture_types;
+    std::span<const SnapshotKeyValue> texture_pixel_formats;
+    std::span<const SnapshotKeyValue> replace_const_buffers;
+    std::optional<u32> viewport_transform_state;
+    u32 texture_bound_buffer{};
+    u32 local_memory_size{};
+    u32 shared_memory_size{};
+    std::array<u32, 3> workgroup_size{};
+    bool has_hle_macro_state{};
+};
+
+} // namespace Shader
@@ -0,0 +1,151 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2026 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <algorithm>
+#include <climits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <shader_compiler/cache/file.h>
+
+namespace Shader {
+
+FileView::~FileView() {
+#ifndef _WIN32
+    if (mapping) {
+        munmap(mapping, data.size());
+    }
+#endif
+}
+
+FileView::FileView(FileView&& other) noexcept
+    : data{std::exchange(other.data, {})}, mapping{std::exchange(other.mapping, nullptr)},
+      buffer{std::move(other.buffer)} {}
+
+FileView& FileView::operator=(FileView&& other) noexcept {
+    std::swap(data, other.data);
+    std::swap(mapping, other.mapping);
+    std::swap(buffer, other.buffer);
+    return *this;
+}
+
+File::File(const std::filesystem::path& path, Mode mode) {
+#ifdef _WIN32
+    int flags{_O_RDONLY};
+    if (mode == Mode::Append) {
+        flags = _O_RDWR | _O_CREAT | _O_APPEND;
+    } else if (mode == Mode::Write) {
+        flags = _O_WRONLY | _O_CREAT | _O_TRUNC;
+    }
+    fd = _wopen(path.c_str(), flags | _O_BINARY | _O_NOINHERIT, _S_IREAD | _S_IWRITE);
+#else
+    int flags{O_RDONLY};
+    if (mode == Mode::Append) {
+        flags = O_RDWR | O_CREAT | O_APPEND;
+    } else if (mode == Mode::Write) {
+        flags = O_WRONLY | O_CREAT | O_TRUNC;
+    }
+    fd = open(path.c_str(), flags | O_CLOEXEC, 0644);
+#endif
+}
+
+File::~File() {
+    if (fd != -1) {
+#ifdef _WIN32
+        _close(fd);
+#else
+        close(fd);
+#endif
+    }
+}
+
+File::File(File&& other) noexcept : fd{std::exchange(other.fd, -1)} {}
+
+File& File::operator=(File&& other) noexcept {
+    std::swap(fd, other.fd);
+    return *this;
+}
+
+std::optional<size_t> File::Size() const {
+#ifdef _WIN32
+    struct _stat64 file_stat {};
+    if (_fstat64(fd, &file_stat) != 0) {
+        return std::nullopt;
+    }
+#else
+    struct stat file_stat {};
+    if (fstat(fd, &file_stat) != 0) {
+        return std::nullopt;
+    }
+#endif
+    return static_cast<size_t>(file_stat.st_size);
+}
+
+bool File::Truncate(size_t size) {
+#ifdef _WIN32
+    return _chsize_s(fd, static_cast<__int64>(size)) == 0;
+#else
+    return ftruncate(fd, static_cast<off_t>(size)) == 0;
+#endif
+}
+
+bool File::Write(std::span<const u8> data) {
+    const u8* ptr{data.data()};
+    size_t remaining{data.size()};
+    while (remaining > 0) {
+#ifdef _WIN32
+        const auto chunk{static_cast<unsigned>(std::min<size_t>(remaining, INT_MAX))};
+        const int written{_write(fd, ptr, chunk)};
+#else
+        const ssize_t written{write(fd, ptr, remaining)};
+#endif
+        if (written < 0) {
+            return false;
+        }
+        ptr += written;
+        remaining -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+std::optional<FileView> File::View(size_t size) const {
+    FileView view;
+    if (size == 0) {
+        return view;
+    }
+#ifdef _WIN32
+    // Mapped files can't be truncated on Windows, so the contents are read into memory instead
+    if (_lseeki64(fd, 0, SEEK_SET) != 0) {
+        return std::nullopt;
+    }
+    view.buffer.resize(size);
+    size_t offset{};
+    while (offset < size) {
+        const auto chunk{static_cast<unsigned>(std::min<size_t>(size - offset, INT_MAX))};
+        const int read_size{_read(fd, view.buffer.data() + offset, chunk)};
+        if (read_size <= 0) {
+            return std::nullopt;
+        }
+        offset += static_cast<size_t>(read_size);
+    }
+    view.data = view.buffer;
+#else
+    void* const mapping{mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0)};
+    if (mapping == MAP_FAILED) {
+        return std::nullopt;
+    }
+    view.mapping = mapping;
+    view.data = std::span(static_cast<const u8*>(mapping), size);
+#endif
+    return view;
+}
+
+} // namespace Shader
@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2026 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <shader_compiler/common/common_types.h>
+
+namespace Shader {
+
+/**
+ * @brief A read-only view of the contents of a file, it's memory mapped on POSIX platforms and
+ * read into memory elsewhere
+ * @note The data is aligned to at least 8 bytes in either case
+ */
+class FileView {
+public:
+    FileView() = default;
+    ~FileView();
+
+    FileView(FileView&& other) noexcept;
+    FileView& operator=(FileView&& other) noexcept;
+
+    FileView(const FileView&) = delete;
+    FileView& operator=(const FileView&) = delete;
+
+    [[nodiscard]] std::span<const u8> Data() const noexcept {
+        return data;
+    }
+
+private:
+    friend class File;
+
+    std::span<const u8> data;
+    void* mapping{};
+    std::vector<u8> buffer;
+};
+
+/// A file accessed through the native file API of the platform, failures are reported to callers
+class File {
+public:
+    enum class Mode {
+        Read,   ///< Opens an existing file for reading
+        Append, ///< Opens or creates a file, reads are allowed and writes are appended
+        Write,  ///< Creates a file or truncates an existing one for writing
+    };
+
+    File() = default;
+    File(const std::filesystem::path& path, Mode mode);
+    ~File();
+
+    File(File&& other) noexcept;
+    File& operator=(File&& other) noexcept;
+
+    File(const File&) = delete;
+    File& operator=(const File&) = delete;
+
+    [[nodiscard]] bool IsOpen() const noexcept {
+        return fd != -1;
+    }
+
+    [[nodiscard]] std::optional<size_t> Size() const;
+
+    [[nodiscard]] bool Truncate(size_t size);
+
+    /// Writes all of the data, retrying partial writes
+    [[nodiscard]] bool Write(std::span<const u8> data);
+
+    /// Views the first bytes of the file, the view stays valid after the file is closed
+    [[nodiscard]] std::optional<FileView> View(size_t size) const;
+
+private:
+    int fd{-1};
+};
+
+} // namespace Shader
@@ -0,0 +1,174 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2026 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <algorithm>
+#include <cstring>
+
+#include <shader_compiler/cache/recording_environment.h>
+
+namespace Shader {
+namespace {
+constexpr u64 HASH_MULTIPLIER{0xff51afd7ed558ccdULL};
+
+constexpr u64 Mix(u64 hash, u64 value) noexcept {
+    hash ^= value;
+    hash *= HASH_MULTIPLIER;
+    return hash ^ (hash >> 33);
+}
+} // Anonymous namespace
+
+u64 HashInstructions(Environment& env, u32 begin, u32 end) {
+    u64 hash{Mix(Mix(0, begin), end)};
+    const CodeReader code{env, begin, end - begin + static_cast<u32>(sizeof(u64))};
+    for (u32 address = begin; address <= end; address += sizeof(u64)) {
+        hash = Mix(hash, code.Read(address));
+    }
+    return hash;
+}
+
+bool MatchesQueries(Environment& env, const EnvironmentQueries& queries) {
+    if (std::memcmp(&env.SPH(), queries.sph.data(), sizeof(ProgramHeader)) != 0 ||
+        env.GpPassthroughMask() != queries.gp_passthrough_mask ||
+        env.IsPropietaryDriver() != queries.is_propietary_driver) {
+        return false;
+    }
+    if (env.TextureBoundBuffer() != queries.texture_bound_buffer ||
+        env.LocalMemorySize() != queries.local_memory_size ||
+        env.SharedMemorySize() != queries.shared_memory_size ||
+        env.WorkgroupSize() != queries.workgroup_size ||
+        env.HasHLEMacroState() != queries.has_hle_macro_state) {
+        return false;
+    }
+    if (HashInstructions(env, queries.code_begin, queries.code_end) != queries.code_hash) {
+        return false;
+    }
+    for (const auto& [key, value] : queries.cbuf_values) {
+        if (env.ReadCbufValue(key.first, key.second) != value) {
+            return false;
+        }
+    }
+    for (const auto& [handle, type] : queries.texture_types) {
+        if (env.ReadTextureType(handle) != type) {
+            return false;
+        }
+    }
+    for (const auto& [handle, format] : queries.texture_pixel_formats) {
+        if (env.ReadTexturePixelFormat(handle) != format) {
+            return false;
+        }
+    }
+    for (const auto& [key, replacement] : queries.replace_const_buffers) {
+        if (env.GetReplaceConstBuffer(key.first, key.second) != replacement) {
+            return false;
+        }
+    }
+    if (queries.viewport_transform_state &&
+        env.ReadViewportTransformState() != *queries.viewport_transform_state) {
+        return false;
+    }
+    return true;
+}
+
+RecordingEnvironment::RecordingEnvironment(Environment& env_) : env{env_} {
+    sph = env.SPH();
+    gp_passthrough_mask = env.GpPassthroughMask();
+    stage = env.ShaderStage();
+    start_address = env.StartAddress();
+    is_propietary_driver = env.IsPropietaryDriver();
+
+    std::memcpy(queries.sph.data(), &sph, sizeof(ProgramHeader));
+    queries.gp_passthrough_mask = gp_passthrough_mask;
+    queries.is_propietary_driver = is_propietary_driver;
+
+    queries.texture_bound_buffer = env.TextureBoundBuffer();
+    queries.local_memory_size = env.LocalMemorySize();
+    queries.shared_memory_size = env.SharedMemorySize();
+    queries.workgroup_size = env.WorkgroupSize();
+    queries.has_hle_macro_state = env.HasHLEMacroState();
+}
+
+u64 RecordingEnvironment::ReadInstruction(u32 address) {
+    min_address = std::min(min_address.value_or(address), address);
+    max_address = std::max(max_address.value_or(address), address);
+    return env.ReadInstruction(address);
+}
+
+u32 RecordingEnvironment::ReadCbufValue(u32 cbuf_index, u32 cbuf_offset) {
+    const u32 value{env.ReadCbufValue(cbuf_index, cbuf_offset)};
+    queries.cbuf_values.insert_or_assign({cbuf_index, cbuf_offset}, value);
+    return value;
+}
+
+void RecordingEnvironment::ReadCbufValues(u32 cbuf_index, u32 cbuf_offset,
+                                          std::span<u32> values) {
+    env.ReadCbufValues(cbuf_index, cbuf_offset, values);
+    for (size_t i = 0; i < values.size(); ++i) {
+        const u32 offset{cbuf_offset + static_cast<u32>(i * sizeof(u32))};
+        queries.cbuf_values.insert_or_assign({cbuf_index, offset}, values[i]);
+    }
+}
+
+TextureType RecordingEnvironment::ReadTextureType(u32 raw_handle) {
+    const TextureType type{env.ReadTextureType(raw_handle)};
+    queries.texture_types.insert_or_assign(raw_handle, type);
+    return type;
+}
+
+TexturePixelFormat RecordingEnvironment::ReadTexturePixelFormat(u32 raw_handle) {
+    const TexturePixelFormat format{env.ReadTexturePixelFormat(raw_handle)};
+    queries.texture_pixel_formats.insert_or_assign(raw_handle, format);
+    return format;
+}
+
+u32 RecordingEnvironment::ReadViewportTransformState() {
+    const u32 state{env.ReadViewportTransformState()};
+    queries.viewport_transform_state = state;
+    return state;
+}
+
+u32 RecordingEnvironment::TextureBoundBuffer() const {
+    return queries.texture_bound_buffer;
+}
+
+u32 RecordingEnvironment::LocalMemorySize() const {
+    return queries.local_memory_size;
+}
+
+u32 RecordingEnvironment::SharedMemorySize() const {
+    return queries.shared_memory_size;
+}
+
+std::array<u32, 3> RecordingEnvironment::WorkgroupSize() const {
+    return queries.workgroup_size;
+}
+
+bool RecordingEnvironment::HasHLEMacroState() const {
+    return queries.has_hle_macro_state;
+}
+
+std::optional<ReplaceConstant> RecordingEnvironment::GetReplaceConstBuffer(u32 bank, u32 offset) {
+    const std::optional<ReplaceConstant> replacement{env.GetReplaceConstBuffer(bank, offset)};
+    queries.replace_const_buffers.insert_or_assign({bank, offset}, replacement);
+    return replacement;
+}
+
+void RecordingEnvironment::Dump(u64 hash) {
+    env.Dump(hash);
+}
+
+EnvironmentQueries RecordingEnvironment::Queries() const {
+    EnvironmentQueries result{queries};
+    if (min_address && max_address) {
+        result.code_begin = *min_address;
+        result.code_end = *max_address;
+        result.code_hash = HashInstructions(env, *min_address, *max_address);
+    } else {
+        // Nothing was read, the instruction at the start address still identifies the shader
+        result.code_begin = env.StartAddress();
+        result.code_end = env.StartAddress();
+        result.code_hash = HashInstructions(env, result.code_begin, result.code_end);
+    }
+    return result;
+}
+
+} // namespace Shader
@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2026 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <array>
+#include <map>
+#include <optional>
+#include <utility>
+
+#include <shader_compiler/common/common_types.h>
+#include <shader_compiler/environment.h>
+
+namespace Shader {
+
+/// Every answer given by an environment that a translation depended on
+struct EnvironmentQueries {
+    u32 code_begin{};
+    u32 code_end{};
+    u64 code_hash{};
+    std::array<u8, sizeof(ProgramHeader)> sph{};
+    std::array<u32, 8> gp_passthrough_mask{};
+    bool is_propietary_driver{};
+    std::map<std::pair<u32, u32>, u32> cbuf_values;
+    std::map<u32, TextureType> texture_types;
+    std::map<u32, TexturePixelFormat> texture_pixel_formats;
+    std::map<std::pair<u32, u32>, std::optional<ReplaceConstant>> replace_const_buffers;
+    std::optional<u32> viewport_transform_state;
+    u32 texture_bound_buffer{};
+    u32 local_memory_size{};
+    u32 shared_memory_size{};
+    std::array<u32, 3> workgroup_size{};
+    bool has_hle_macro_state{};
+};
+
+/// Hashes the instruction words in the [begin, end] byte range served by an environment
+[[nodiscard]] u64 HashInstructions(Environment& env, u32 begin, u32 end);
+
+/// Checks if an environment gives the same answers as the ones recorded in the queries
+[[nodiscard]] bool MatchesQueries(Environment& env, const EnvironmentQueries& queries);
+
+/**
+ * @brief Environment wrapper forwarding every query to another environment while recording the
+ * answers, these can later be used to validate that a translation is still valid for a shader
+ * @note Code views aren't forwarded so that every instruction read is recorded
+ */
+class RecordingEnvironment final : public Environment {
+public:
+    explicit RecordingEnvironment(Environment& env_);
+
+    [[nodiscard]] u64 ReadInstruction(u32 address) override;
+
+    [[nodiscard]] u32 ReadCbufValue(u32 cbuf_index, u32 cbuf_offset) override;
+
+    void ReadCbufValues(u32 cbuf_index, u32 cbuf_offset, std::span<u32> values) override;
+
+    [[nodiscard]] TextureType ReadTextureType(u32 raw_handle) override;
+
+    [[nodiscard]] TexturePixelFormat ReadTexturePixelFormat(u32 raw_handle) override;
+
+    [[nodiscard]] u32 ReadViewportTransformState() override;
+
+    [[nodiscard]] u32 TextureBoundBuffer() const override;
+
+    [[nodiscard]] u32 LocalMemorySize() const override;
+
+    [[nodiscard]] u32 SharedMemorySize() const override;
+
+    [[nodiscard]] std::array<u32, 3> WorkgroupSize() const override;
+
+    [[nodiscard]] bool HasHLEMacroState() const override;
+
+    [[nodiscard]] std::optional<ReplaceConstant> GetReplaceConstBuffer(u32 bank,
+                                                                       u32 offset) override;
+
+    void Dump(u64 hash) override;
+
+    /// Finalizes the recorded queries, this hashes the instruction range that was read
+    [[nodiscard]] EnvironmentQueries Queries() const;
+
+private:
+    Environment& env;
+    EnvironmentQueries queries;
+    std::optional<u32> min_address;
+    std::optional<u32> max_address;
+};
+
+} // namespace Shader
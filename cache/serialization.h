@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2026 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <cstring>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include <shader_compiler/common/common_types.h>
+
+namespace Shader {
+
+/// Appends trivially copyable values to a byte buffer in host byte order
+class BinaryWriter {
+public:
+    template <typename T>
+    requires std::is_trivially_copyable_v<T>
+    void Write(const T& value) {
+        const auto* const bytes{reinterpret_cast<const u8*>(&value)};
+        data.insert(data.end(), bytes, bytes + sizeof(T));
+    }
+
+    void Write(std::span<const u8> bytes) {
+        data.insert(data.end(), bytes.begin(), bytes.end());
+    }
+
+    std::vector<u8> data;
+};
+
+/// Reads trivially copyable values from a byte buffer, reads past the end yield empty optionals
+class BinaryReader {
+public:
+    explicit BinaryReader(std::span<const u8> data_) : data{data_} {}
+
+    template <typename T>
+    requires std::is_trivially_copyable_v<T>
+    [[nodiscard]] std::optional<T> Read() {
+        if (data.size() - offset < sizeof(T)) {
+            return std::nullopt;
+        }
+        T value;
+        std::memcpy(&value, data.data() + offset, sizeof(T));
+        offset += sizeof(T);
+        return value;
+    }
+
+    [[nodiscard]] std::optional<std::span<const u8>> Read(size_t size) {
+        if (data.size() - offset < size) {
+            return std::nullopt;
+        }
+        const std::span<const u8> result{data.subspan(offset, size)};
+        offset += size;
+        return result;
+    }
+
+    [[nodiscard]] size_t Offset() const noexcept {
+        return offset;
+    }
+
+    [[nodiscard]] bool Empty() const noexcept {
+        return offset == data.size();
+    }
+
+private:
+    std::span<const u8> data;
+    size_t offset{};
+};
+
+} // namespace Shader
@@ -0,0 +1,320 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2026 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <algorithm>
+#include <cstring>
+
+#include <shader_compiler/cache/serialization.h>
+#include <shader_compiler/cache/translation_cache.h>
+#include <shader_compiler/exception.h>
+
+namespace Shader {
+namespace {
+constexpr u64 CACHE_MAGIC{0x4548434143435348ULL}; // "HSCCACHE"
+constexpr u32 CACHE_FORMAT_VERSION{3};
+
+/// Amount of instruction words hashed to look up candidate entries
+constexpr u32 PREFIX_WORDS{32};
+
+struct Header {
+    u64 magic;
+    u32 format_version;
+    u32 version;
+};
+
+struct EntryHeader {
+    u64 key;
+    u32 stage;
+    u32 start_address;
+    u32 code_begin;
+    u32 code_end;
+    u64 code_hash;
+    u64 prefix_hash;
+    u32 prefix_end;
+    std::array<u8, sizeof(ProgramHeader)> sph;
+    std::array<u32, 8> gp_passthrough_mask;
+    u32 is_propietary_driver;
+    u32 texture_bound_buffer;
+    u32 local_memory_size;
+    u32 shared_memory_size;
+    std::array<u32, 3> workgroup_size;
+    u32 has_hle_macro_state;
+    u32 has_viewport_transform_state;
+    u32 viewport_transform_state;
+    u32 num_cbuf_values;
+    u32 num_texture_types;
+    u32 num_texture_pixel_formats;
+    u32 num_replace_const_buffers;
+    u32 payload_size;
+};
+
+struct KeyValue {
+    u32 key_a;
+    u32 key_b;
+    u32 value;
+};
+
+u32 PrefixEnd(u32 code_begin, u32 code_end) {
+    return std::min(code_end, code_begin + (PREFIX_WORDS - 1) * static_cast<u32>(sizeof(u64)));
+}
+
+u64 PrefixKey(Stage stage, u64 prefix_hash) {
+    return prefix_hash ^ (static_cast<u64>(stage) * 0x9e3779b97f4a7c15ULL);
+}
+
+std::vector<u8> SerializeEntry(u64 key, Stage stage, u32 start_address, u32 prefix_end,
+                               u64 prefix_hash, const EnvironmentQueries& queries,
+                               std::span<const u8> payload) {
+    // The header is written raw, so it's cleared to avoid writing indeterminate padding bytes
+    EntryHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.key = key;
+    header.stage = static_cast<u32>(stage);
+    header.start_address = start_address;
+    header.code_begin = queries.code_begin;
+    header.code_end = queries.code_end;
+    header.code_hash = queries.code_hash;
+    header.prefix_hash = prefix_hash;
+    header.prefix_end = prefix_end;
+    header.sph = queries.sph;
+    header.gp_passthrough_mask = queries.gp_passthrough_mask;
+    header.is_propietary_driver = queries.is_propietary_driver ? 1U : 0U;
+    header.texture_bound_buffer = queries.texture_bound_buffer;
+    header.local_memory_size = queries.local_memory_size;
+    header.shared_memory_size = queries.shared_memory_size;
+    header.workgroup_size = queries.workgroup_size;
+    header.has_hle_macro_state = queries.has_hle_macro_state ? 1U : 0U;
+    header.has_viewport_transform_state = queries.viewport_transform_state ? 1U : 0U;
+    header.viewport_transform_state = queries.viewport_transform_state.value_or(0);
+    header.num_cbuf_values = static_cast<u32>(queries.cbuf_values.size());
+    header.num_texture_types = static_cast<u32>(queries.texture_types.size());
+    header.num_texture_pixel_formats = static_cast<u32>(queries.texture_pixel_formats.size());
+    header.num_replace_const_buffers = static_cast<u32>(queries.replace_const_buffers.size());
+    header.payload_size = static_cast<u32>(payload.size());
+    BinaryWriter writer;
+    writer.Write(header);
+    for (const auto& [location, value] : queries.cbuf_values) {
+        writer.Write(KeyValue{location.first, location.second, value});
+    }
+    for (const auto& [handle, type] : queries.texture_types) {
+        writer.Write(KeyValue{handle, 0, static_cast<u32>(type)});
+    }
+    for (const auto& [handle, format] : queries.texture_pixel_formats) {
+        writer.Write(KeyValue{handle, 0, static_cast<u32>(format)});
+    }
+    for (const auto& [location, replacement] : queries.replace_const_buffers) {
+        // Missing replacements are encoded with the all ones value
+        const u32 value{replacement ? static_cast<u32>(*replacement) : ~0U};
+        writer.Write(KeyValue{location.first, location.second, value});
+    }
+    writer.Write(payload);
+    return std::move(writer.data);
+}
+
+template <typename Callable>
+bool ReadKeyValues(BinaryReader& reader, u32 count, Callable&& func) {
+    for (u32 index = 0; index < count; ++index) {
+        const std::optional<KeyValue> key_value{reader.Read<KeyValue>()};
+        if (!key_value) {
+            return false;
+        }
+        func(*key_value);
+    }
+    return true;
+}
+} // Anonymous namespace
+
+TranslationCache::TranslationCache(std::filesystem::path path_, u32 version_)
+    : path{std::move(path_)}, version{version_} {
+    Load();
+}
+
+TranslationCache::~TranslationCache() = default;
+
+std::optional<std::span<const u8>> TranslationCache::Find(u64 key, Environment& env) {
+    // Environment queries may read guest memory so they're made without holding the lock, entries
+    // are immutable once added and the deque keeps references to them stable
+    std::vector<std::pair<u32, u32>> ranges;
+    {
+        std::scoped_lock lock{mutex};
+        const auto ranges_it{prefix_ranges.find({env.ShaderStage(), env.StartAddress()})};
+        if (ranges_it == prefix_ranges.end()) {
+            return std::nullopt;
+        }
+        ranges.assign(ranges_it->second.begin(), ranges_it->second.end());
+    }
+    std::vector<const Entry*> candidates;
+    for (const auto& [code_begin, prefix_end] : ranges) {
+        const u64 prefix_hash{HashInstructions(env, code_begin, prefix_end)};
+        const u64 prefix_key{PrefixKey(env.ShaderStage(), prefix_hash)};
+        candidates.clear();
+        {
+            std::scoped_lock lock{mutex};
+            const auto [begin, end]{entries_by_prefix.equal_range(prefix_key)};
+            for (auto it = begin; it != end; ++it) {
+                const Entry& entry{entries[it->second]};
+                if (entry.key == key && entry.stage == env.ShaderStage() &&
+                    entry.start_address == env.StartAddress() &&
+                    entry.queries.code_begin == code_begin && entry.prefix_end == prefix_end) {
+                    candidates.push_back(&entry);
+                }
+            }
+        }
+        for (const Entry* const entry : candidates) {
+            if (MatchesQueries(env, entry->queries)) {
+                return entry->payload;
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+void TranslationCache::Insert(u64 key, RecordingEnvironment& env, std::span<const u8> payload) {
+    EnvironmentQueries queries{env.Queries()};
+    const u32 prefix_end{PrefixEnd(queries.code_begin, queries.code_end)};
+    const u64 prefix_hash{HashInstructions(env, queries.code_begin, prefix_end)};
+    std::vector<u8> data{SerializeEntry(key, env.ShaderStage(), env.StartAddress(), prefix_end,
+                                        prefix_hash, queries, payload)};
+
+    Entry entry{
+        .key = key,
+        .stage = env.ShaderStage(),
+        .start_address = env.StartAddress(),
+        .prefix_end = prefix_end,
+        .prefix_hash = prefix_hash,
+        .queries = std::move(queries),
+        .payload{},
+        .owned_payload{payload.begin(), payload.end()},
+    };
+    entry.payload = entry.owned_payload;
+
+    std::scoped_lock lock{mutex};
+    Append(data);
+    AddEntry(std::move(entry));
+}
+
+size_t TranslationCache::NumEntries() const {
+    std::scoped_lock lock{mutex};
+    return entries.size();
+}
+
+void TranslationCache::Load() {
+    file = File{path, File::Mode::Append};
+    if (!file.IsOpen()) {
+        throw RuntimeError("Failed to open translation cache {}", path.string());
+    }
+    const std::optional<size_t> file_size{file.Size()};
+    if (!file_size) {
+        throw RuntimeError("Failed to stat translation cache {}", path.string());
+    }
+    const auto reset{[&] {
+        if (!file.Truncate(0)) {
+            throw RuntimeError("Failed to truncate translation cache {}", path.string());
+        }
+        BinaryWriter writer;
+        writer.Write(Header{
+            .magic = CACHE_MAGIC,
+            .format_version = CACHE_FORMAT_VERSION,
+            .version = version,
+        });
+        Append(writer.data);
+    }};
+    if (*file_size < sizeof(Header)) {
+        reset();
+        return;
+    }
+    std::optional<FileView> view{file.View(*file_size)};
+    if (!view) {
+        throw RuntimeError("Failed to map translation cache {}", path.string());
+    }
+    mapping = std::move(*view);
+
+    BinaryReader reader{mapping.Data()};
+    const Header header{*reader.Read<Header>()};
+    if (header.magic != CACHE_MAGIC || header.format_version != CACHE_FORMAT_VERSION ||
+        header.version != version) {
+        mapping = FileView{};
+        reset();
+        return;
+    }
+    size_t valid_end{reader.Offset()};
+    while (!reader.Empty()) {
+        // Stop at the first truncated entry, it was most likely interrupted while being written
+        const std::optional<EntryHeader> entry_header{reader.Read<EntryHeader>()};
+        if (!entry_header) {
+            break;
+        }
+        Entry entry;
+        entry.key = entry_header->key;
+        entry.stage = static_cast<Stage>(entry_header->stage);
+        entry.start_address = entry_header->start_address;
+        entry.prefix_end = entry_header->prefix_end;
+        entry.prefix_hash = entry_header->prefix_hash;
+        EnvironmentQueries& queries{entry.queries};
+        queries.code_begin = entry_header->code_begin;
+        queries.code_end = entry_header->code_end;
+        queries.code_hash = entry_header->code_hash;
+        queries.sph = entry_header->sph;
+        queries.gp_passthrough_mask = entry_header->gp_passthrough_mask;
+        queries.is_propietary_driver = entry_header->is_propietary_driver != 0;
+        queries.texture_bound_buffer = entry_header->texture_bound_buffer;
+        queries.local_memory_size = entry_header->local_memory_size;
+        queries.shared_memory_size = entry_header->shared_memory_size;
+        queries.workgroup_size = entry_header->workgroup_size;
+        queries.has_hle_macro_state = entry_header->has_hle_macro_state != 0;
+        if (entry_header->has_viewport_transform_state != 0) {
+            queries.viewport_transform_state = entry_header->viewport_transform_state;
+        }
+        const bool is_valid{
+            ReadKeyValues(reader, entry_header->num_cbuf_values,
+                          [&](const KeyValue& kv) {
+                              queries.cbuf_values.emplace(std::pair{kv.key_a, kv.key_b}, kv.value);
+                          }) &&
+            ReadKeyValues(reader, entry_header->num_texture_types,
+                          [&](const KeyValue& kv) {
+                              queries.texture_types.emplace(kv.key_a,
+                                                            static_cast<TextureType>(kv.value));
+                          }) &&
+            ReadKeyValues(reader, entry_header->num_texture_pixel_formats,
+                          [&](const KeyValue& kv) {
+                              queries.texture_pixel_formats.emplace(
+                                  kv.key_a, static_cast<TexturePixelFormat>(kv.value));
+                          }) &&
+            ReadKeyValues(reader, entry_header->num_replace_const_buffers,
+                          [&](const KeyValue& kv) {
+                              std::optional<ReplaceConstant> replacement;
+                              if (kv.value != ~0U) {
+                                  replacement = static_cast<ReplaceConstant>(kv.value);
+                              }
+                              queries.replace_const_buffers.emplace(std::pair{kv.key_a, kv.key_b},
+                                                                    replacement);
+                          })};
+        const std::optional<std::span<const u8>> payload{reader.Read(entry_header->payload_size)};
+        if (!is_valid || !payload) {
+            break;
+        }
+        entry.payload = *payload;
+        AddEntry(std::move(entry));
+        valid_end = reader.Offset();
+    }
+    // Entries appended after a truncated entry couldn't be read back, so it's cut off the file
+    if (valid_end != *file_size && !file.Truncate(valid_end)) {
+        throw RuntimeError("Failed to truncate translation cache {}", path.string());
+    }
+}
+
+void TranslationCache::AddEntry(Entry&& entry) {
+    const u32 code_begin{entry.queries.code_begin};
+    const u32 prefix_end{entry.prefix_end};
+    prefix_ranges[{entry.stage, entry.start_address}].emplace(code_begin, prefix_end);
+    entries_by_prefix.emplace(PrefixKey(entry.stage, entry.prefix_hash), entries.size());
+    entries.push_back(std::move(entry));
+}
+
+void TranslationCache::Append(std::span<const u8> data) {
+    if (!file.Write(data)) {
+        throw RuntimeError("Failed to write translation cache {}", path.string());
+    }
+}
+
+} // namespace Shader
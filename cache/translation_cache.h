@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2026 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <shader_compiler/cache/file.h>
+#include <shader_compiler/cache/recording_environment.h>
+#include <shader_compiler/common/common_types.h>
+#include <shader_compiler/environment.h>
+
+namespace Shader {
+
+/**
+ * @brief A persistent cache of translation artifacts keyed by the instruction stream of a shader
+ * and validated against every environment query the translation depended on
+ * @note The payload of an entry is opaque to the cache, it is usually the emitted SPIR-V alongside
+ * any metadata the caller requires to use it
+ * @note Entries loaded from disk are served directly from a read-only view of the file, which is
+ * memory mapped where supported
+ */
+class TranslationCache {
+public:
+    /**
+     * @param path The file backing the cache, it is created if it doesn't exist
+     * @param version A caller defined version, a file with a different version is discarded
+     */
+    explicit TranslationCache(std::filesystem::path path, u32 version);
+    ~TranslationCache();
+
+    TranslationCache(const TranslationCache&) = delete;
+    TranslationCache& operator=(const TranslationCache&) = delete;
+
+    /**
+     * @param key A caller defined hash of all translation state outside of the environment, such
+     * as the profile, runtime info and compile options
+     * @return The payload of an entry that is valid for the key and environment, the span is valid
+     * for the lifetime of the cache
+     */
+    [[nodiscard]] std::optional<std::span<const u8>> Find(u64 key, Environment& env);
+
+    /**
+     * @brief Inserts an entry for the translation recorded by the environment and appends it to
+     * disk
+     * @param key The same key the entry will be looked up with, see Find
+     */
+    void Insert(u64 key, RecordingEnvironment& env, std::span<const u8> payload);
+
+    [[nodiscard]] size_t NumEntries() const;
+
+private:
+    struct Entry {
+        u64 key{};
+        Stage stage{};
+        u32 start_address{};
+        u32 prefix_end{};
+        u64 prefix_hash{};
+        EnvironmentQueries queries;
+        std::span<const u8> payload;
+        std::vector<u8> owned_payload;
+    };
+
+    /// Instruction ranges hashed to look up entries of a stage and start address
+    using PrefixRanges = std::set<std::pair<u32, u32>>;
+
+    void Load();
+
+    void AddEntry(Entry&& entry);
+
+    void Append(std::span<const u8> data);
+
+    std::filesystem::path path;
+    u32 version;
+    mutable std::mutex mutex;
+    std::deque<Entry> entries;
+    std::map<std::pair<Stage, u32>, PrefixRanges> prefix_ranges;
+    std::unordered_multimap<u64, size_t> entries_by_prefix;
+    File file;
+    FileView mapping;
+};
+
+} // namespace Shader
@@ -7,20 +7,15 @@
 
 namespace Shader::Settings {
     /**
-     * @note Only contains the settings relevant to the shader compiler
+     * @note Only contains the settings relevant to the shader compiler, these are supplied per
+     * compilation through Shader::CompileOptions rather than being read from global state
      */
-    struct Values {
-        bool renderer_debug;
-        bool disable_shader_loop_safety_checks;
-        struct ResolutionScalingInfo {
-            u32 up_scale{1};
-            u32 down_shift{0};
-            f32 up_factor{1.0f};
-            f32 down_factor{1.0f};
-            bool active{};
-            bool downscale{};
-        } resolution_info;
+    struct ResolutionScalingInfo {
+        u32 up_scale{1};
+        u32 down_shift{0};
+        f32 up_factor{1.0f};
+        f32 down_factor{1.0f};
+        bool active{};
+        bool downscale{};
     };
-
-    static inline Values values{}; //!< A static structure with the values set by Skyline code
 }
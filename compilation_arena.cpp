@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2026 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <algorithm>
+
+#include <shader_compiler/compilation_arena.h>
+
+namespace Shader {
+
+ArenaMemoryResource::ArenaMemoryResource(size_t initial_size) : block_size{initial_size} {
+    AddBlock(initial_size);
+}
+
+void ArenaMemoryResource::Release() {
+    if (blocks.size() > 1) {
+        // The previous use spilled, squash every block into a single one
+        blocks.clear();
+        const size_t total_size{capacity};
+        capacity = 0;
+        AddBlock(total_size);
+    } else {
+        cursor = blocks.front().memory.get();
+        remaining = blocks.front().size;
+    }
+    bytes_in_use = 0;
+}
+
+void* ArenaMemoryResource::do_allocate(size_t bytes, size_t alignment) {
+    void* pointer{cursor};
+    size_t space{remaining};
+    if (!std::align(alignment, bytes, pointer, space)) {
+        AddBlock(std::max(block_size, bytes + alignment));
+        pointer = cursor;
+        space = remaining;
+        std::align(alignment, bytes, pointer, space);
+    }
+    std::byte* const end{static_cast<std::byte*>(pointer) + bytes};
+    bytes_in_use += static_cast<size_t>(end - cursor);
+    cursor = end;
+    remaining = space - bytes;
+    return pointer;
+}
+
+void ArenaMemoryResource::AddBlock(size_t size) {
+    blocks.push_back(Block{
+        .memory = std::make_unique_for_overwrite<std::byte[]>(size),
+        .size = size,
+    });
+    cursor = blocks.back().memory.get();
+    remaining = size;
+    capacity += size;
+}
+
+CompilationArena::CompilationArena(size_t initial_size) : memory{initial_size} {}
+
+void CompilationArena::ReserveShards(size_t count) {
+    while (shards.size() < count) {
+        shards.push_back(std::make_unique<ArenaShard>());
+    }
+}
+
+void CompilationArena::Reset() {
+    high_water_mark = std::max(high_water_mark, BytesInUse());
+    flow_block_pool.DiscardContents();
+    block_pool.DiscardContents();
+    inst_pool.DiscardContents();
+    memory.Release();
+    for (const std::unique_ptr<ArenaShard>& shard : shards) {
+        shard->inst_pool.DiscardContents();
+        shard->memory.Release();
+    }
+}
+
+size_t CompilationArena::BytesInUse() const noexcept {
+    size_t bytes{memory.BytesInUse() + inst_pool.NumObjects() * sizeof(IR::Inst) +
+                 block_pool.NumObjects() * sizeof(IR::Block) +
+                 flow_block_pool.NumObjects() * sizeof(Maxwell::Flow::Block)};
+    for (const std::unique_ptr<ArenaShard>& shard : shards) {
+        bytes += shard->memory.BytesInUse() + shard->inst_pool.NumObjects() * sizeof(IR::Inst);
+    }
+    return bytes;
+}
+
+size_t CompilationArena::HighWaterMark() const noexcept {
+    return std::max(high_water_mark, BytesInUse());
+}
+
+} // namespace Shader
@@ -0,0 +1,161 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2026 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <memory>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+#include <shader_compiler/common/common_types.h>
+#include <shader_compiler/frontend/ir/basic_block.h>
+#include <shader_compiler/frontend/ir/value.h>
+#include <shader_compiler/frontend/maxwell/control_flow.h>
+#include <shader_compiler/object_pool.h>
+
+namespace Shader {
+
+/**
+ * @brief A monotonic memory resource which keeps its memory across releases, deallocation is a
+ * no-op and all memory is reclaimed at once by Release
+ */
+class ArenaMemoryResource final : public std::pmr::memory_resource {
+public:
+    explicit ArenaMemoryResource(size_t initial_size);
+
+    ArenaMemoryResource(const ArenaMemoryResource&) = delete;
+    ArenaMemoryResource& operator=(const ArenaMemoryResource&) = delete;
+
+    /**
+     * @brief Reclaims every allocation in O(1) by rewinding to the start of the first block
+     * @note If the previous use spilled into further blocks they're squashed into a single block
+     * large enough to hold all of them, subsequent uses of a similar size never allocate
+     */
+    void Release();
+
+    /// The amount of bytes handed out since the last release, including alignment padding
+    [[nodiscard]] size_t BytesInUse() const noexcept {
+        return bytes_in_use;
+    }
+
+    /// The amount of bytes reserved from the global heap
+    [[nodiscard]] size_t Capacity() const noexcept {
+        return capacity;
+    }
+
+private:
+    struct Block {
+        std::unique_ptr<std::byte[]> memory;
+        size_t size;
+    };
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+
+    void do_deallocate(void*, size_t, size_t) noexcept override {}
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    void AddBlock(size_t size);
+
+    std::vector<Block> blocks;
+    std::byte* cursor{};
+    size_t remaining{};
+    size_t bytes_in_use{};
+    size_t capacity{};
+    size_t block_size;
+};
+
+/**
+ * @brief The allocations of one worker while other workers allocate from the same compilation,
+ * every worker creates instructions from its own shard so no synchronization is needed
+ */
+struct ArenaShard {
+    static constexpr size_t INITIAL_SIZE{64 * 1024};
+    static constexpr size_t INST_CHUNK_SIZE{1024};
+
+    ArenaShard() : memory{INITIAL_SIZE}, inst_pool{INST_CHUNK_SIZE} {}
+
+    ArenaMemoryResource memory;
+    ObjectPool<IR::Inst> inst_pool;
+};
+
+/**
+ * @brief Owns every allocation made while compiling a single shader: IR instructions and blocks,
+ * control flow blocks, structurizer statements and the containers hanging off all of them
+ * @note The arena is reused by resetting it between shaders, after the first few shaders all
+ * memory is recycled and compilations no longer touch the global heap
+ */
+class CompilationArena {
+public:
+    static constexpr size_t DEFAULT_INITIAL_SIZE{256 * 1024};
+
+    explicit CompilationArena(size_t initial_size = DEFAULT_INITIAL_SIZE);
+
+    CompilationArena(const CompilationArena&) = delete;
+    CompilationArena& operator=(const CompilationArena&) = delete;
+
+    [[nodiscard]] ObjectPool<IR::Inst>& InstPool() noexcept {
+        return inst_pool;
+    }
+
+    [[nodiscard]] ObjectPool<IR::Block>& BlockPool() noexcept {
+        return block_pool;
+    }
+
+    [[nodiscard]] ObjectPool<Maxwell::Flow::Block>& FlowBlockPool() noexcept {
+        return flow_block_pool;
+    }
+
+    /// The memory resource backing per-compilation containers
+    [[nodiscard]] std::pmr::memory_resource& Memory() noexcept {
+        return memory;
+    }
+
+    /**
+     * @brief Makes sure there are at least the requested amount of shards
+     * @note This must not be called while the shards are in use
+     */
+    void ReserveShards(size_t count);
+
+    /// Gets a shard previously reserved, distinct shards may be used concurrently
+    [[nodiscard]] ArenaShard& Shard(size_t index) noexcept {
+        return *shards[index];
+    }
+
+    /**
+     * @brief Creates an object in arena memory which is never destroyed
+     * @note The object must not own memory outside of the arena
+     */
+    template <typename T, typename... Args>
+    [[nodiscard]] T* Create(Args&&... args) {
+        void* const pointer{memory.allocate(sizeof(T), alignof(T))};
+        return std::construct_at(static_cast<T*>(pointer), std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Reclaims everything allocated from the arena, nothing created before may be used
+     * @note Instructions, IR blocks and control flow blocks are discarded without being destroyed
+     * as all of their memory comes from the arena, this makes a reset independent of the size of
+     * the shader. Shards are reset alongside the arena and kept for the next compilation
+     */
+    void Reset();
+
+    /// The amount of bytes used by the current compilation
+    [[nodiscard]] size_t BytesInUse() const noexcept;
+
+    /// The largest amount of bytes used by a single compilation since the arena was created
+    [[nodiscard]] size_t HighWaterMark() const noexcept;
+
+private:
+    ArenaMemoryResource memory;
+    ObjectPool<IR::Inst> inst_pool;
+    ObjectPool<IR::Block> block_pool;
+    ObjectPool<Maxwell::Flow::Block> flow_block_pool;
+    std::vector<std::unique_ptr<ArenaShard>> shards;
+    size_t high_water_mark{};
+};
+
+} // namespace Shader
@@ -0,0 +1,36 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2026 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <shader_compiler/common/settings.h>
+
+namespace Shader {
+
+class InstrumentationSink;
+class WorkStealingThreadPool;
+
+/**
+ * @brief Options affecting a single compilation, these are passed explicitly through the
+ * translation and emission entry points so concurrent compilations can use different options
+ */
+struct CompileOptions {
+    /// Runs the IR verification pass after the optimization passes
+    bool renderer_debug{};
+    /// Omits the iteration limit guarding loops against hangs in emitted code
+    bool disable_shader_loop_safety_checks{};
+    /// Resolution scaling applied by the rescaling pass when active
+    Settings::ResolutionScalingInfo resolution_info{};
+    /// Receives the statistics of every pass when set, nothing is measured otherwise
+    InstrumentationSink* instrumentation{};
+    /**
+     * @brief Translates the blocks of large shaders concurrently on this pool when set
+     * @note The pool must not be the one running the compilation as it waits on the pool, the
+     * const queries of the environment are made from the workers
+     */
+    WorkStealingThreadPool* translation_pool{};
+    /// The amount of instructions a shader needs for its blocks to be translated concurrently
+    size_t parallel_translation_threshold{8192};
+};
+
+} // namespace Shader
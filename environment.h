@@ -4,6 +4,8 @@
 #pragma once
 
 #include <array>
+#include <limits>
+#include <span>
 
 #include <shader_compiler/common/common_types.h>
 #include <shader_compiler/program_header.h>
@@ -18,8 +20,31 @@ public:
 
     [[nodiscard]] virtual u64 ReadInstruction(u32 address) = 0;
 
+    /**
+     * @brief Exposes the instruction words in [address, address + size) as a contiguous span
+     * @return A span starting at the address which may be shorter than requested, or empty if the
+     * environment can't expose its code directly. Words outside of it must be read through
+     * ReadInstruction
+     * @note The span must stay valid for as long as the environment
+     */
+    [[nodiscard]] virtual std::span<const u64> CodeView(u32 /*address*/, u32 /*size*/) {
+        return {};
+    }
+
     [[nodiscard]] virtual u32 ReadCbufValue(u32 cbuf_index, u32 cbuf_offset) = 0;
 
+    /**
+     * @brief Reads consecutive words of a constant buffer starting at the offset, one per value
+     * @note Environments with direct access to the buffer should override this to read the whole
+     * range at once, the default reads each word through ReadCbufValue
+     */
+    virtual void ReadCbufValues(u32 cbuf_index, u32 cbuf_offset, std::span<u32> values) {
+        for (size_t i = 0; i < values.size(); ++i) {
+            values[i] = ReadCbufValue(cbuf_index,
+                                      cbuf_offset + static_cast<u32>(i * sizeof(u32)));
+        }
+    }
+
     [[nodiscard]] virtual TextureType ReadTextureType(u32 raw_handle) = 0;
 
     [[nodiscard]] virtual TexturePixelFormat ReadTexturePixelFormat(u32 raw_handle) = 0;
@@ -69,4 +94,37 @@ protected:
     bool is_propietary_driver{};
 };
 
+/**
+ * @brief Reads instruction words from a single code view of an environment, avoiding a virtual call
+ * per word when the environment supports code views
+ */
+class CodeReader {
+public:
+    /// Requests a view of every word from the address onwards
+    explicit CodeReader(Environment& env_, u32 address)
+        : CodeReader(env_, address, std::numeric_limits<u32>::max() - address) {}
+
+    explicit CodeReader(Environment& env_, u32 address, u32 size)
+        : env{&env_}, code{env_.CodeView(address, size)}, base{address} {}
+
+    [[nodiscard]] u64 Read(u32 address) const {
+        // Addresses below the base wrap around and fall outside of the view
+        const size_t index{(address - base) / sizeof(u64)};
+        if (index < code.size()) {
+            return code[index];
+        }
+        return env->ReadInstruction(address);
+    }
+
+    /// The words of the code view starting at the base, empty if the environment has no views
+    [[nodiscard]] std::span<const u64> View() const noexcept {
+        return code;
+    }
+
+private:
+    Environment* env;
+    std::span<const u64> code;
+    u32 base;
+};
+
 } // namespace Shader
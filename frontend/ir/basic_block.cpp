@@ -7,12 +7,17 @@
 #include <map>
 
 #include <shader_compiler/common/common_types.h>
+#include <shader_compiler/compilation_arena.h>
 #include <shader_compiler/frontend/ir/basic_block.h>
 #include <shader_compiler/frontend/ir/value.h>
 
 namespace Shader::IR {
 
-Block::Block(ObjectPool<Inst>& inst_pool_) : inst_pool{&inst_pool_} {}
+Block::Block(CompilationArena& arena) : Block{arena.InstPool(), arena.Memory()} {}
+
+Block::Block(ObjectPool<Inst>& inst_pool_, std::pmr::memory_resource& memory_)
+    : inst_pool{&inst_pool_}, memory{&memory_}, imm_predecessors{memory},
+      imm_successors{memory} {}
 
 Block::~Block() = default;
 
@@ -27,7 +32,7 @@ Block::iterator Block::PrependNewInst(iterator insertion_point, const Inst& base
 
 Block::iterator Block::PrependNewInst(iterator insertion_point, Opcode op,
                                       std::initializer_list<Value> args, u32 flags) {
-    Inst* const inst{inst_pool->Create(op, flags)};
+    Inst* const inst{inst_pool->Create(op, flags, memory)};
     const auto result_it{instructions.insert(insertion_point, *inst)};
 
     if (inst->NumArgs() != args.size()) {
@@ -51,6 +56,16 @@ void Block::AddBranch(Block* block) {
     block->imm_predecessors.push_back(this);
 }
 
+void Block::RemoveBranch(Block* block) {
+    const auto successor{ranges::find(imm_successors, block)};
+    const auto predecessor{ranges::find(block->imm_predecessors, this)};
+    if (successor == imm_successors.end() || predecessor == block->imm_predecessors.end()) {
+        throw LogicError("Branch does not exist");
+    }
+    imm_successors.erase(successor);
+    block->imm_predecessors.erase(predecessor);
+}
+
 static std::string BlockToIndex(const std::map<const Block*, size_t>& block_to_index,
                                 Block* block) {
     if (const auto it{block_to_index.find(block)}; it != block_to_index.end()) {
@@ -5,6 +5,7 @@
 
 #include <initializer_list>
 #include <map>
+#include <memory_resource>
 #include <span>
 #include <vector>
 
@@ -16,6 +17,10 @@
 #include <shader_compiler/frontend/ir/value.h>
 #include <shader_compiler/object_pool.h>
 
+namespace Shader {
+class CompilationArena;
+}
+
 namespace Shader::IR {
 
 class Block {
@@ -27,7 +32,9 @@ public:
     using reverse_iterator = InstructionList::reverse_iterator;
     using const_reverse_iterator = InstructionList::const_reverse_iterator;
 
-    explicit Block(ObjectPool<Inst>& inst_pool_);
+    explicit Block(CompilationArena& arena);
+    /// Creates a block allocating its instructions from a specific pool and memory resource
+    explicit Block(ObjectPool<Inst>& inst_pool, std::pmr::memory_resource& memory);
     ~Block();
 
     Block(const Block&) = delete;
@@ -49,6 +56,9 @@ public:
     /// Adds a new branch to this basic block.
     void AddBranch(Block* block);
 
+    /// Removes an existing branch from this basic block, phis of the target are left untouched.
+    void RemoveBranch(Block* block);
+
     /// Gets a mutable reference to the instruction list for this basic block.
     [[nodiscard]] InstructionList& Instructions() noexcept {
         return instructions;
@@ -58,6 +68,11 @@ public:
         return instructions;
     }
 
+    /// Gets the memory resource instructions of this block are allocated from.
+    [[nodiscard]] std::pmr::memory_resource& Memory() const noexcept {
+        return *memory;
+    }
+
     /// Gets an immutable span to the immediate predecessors.
     [[nodiscard]] std::span<Block* const> ImmPredecessors() const noexcept {
         return imm_predecessors;
@@ -79,13 +94,6 @@ public:
         return Common::BitCast<DefinitionType>(definition);
     }
 
-    void SetSsaRegValue(IR::Reg reg, const Value& value) noexcept {
-        ssa_reg_values[RegIndex(reg)] = value;
-    }
-    const Value& SsaRegValue(IR::Reg reg) const noexcept {
-        return ssa_reg_values[RegIndex(reg)];
-    }
-
     void SsaSeal() noexcept {
         is_ssa_sealed = true;
     }
@@ -168,17 +176,17 @@ public:
 private:
     /// Memory pool for instruction list
     ObjectPool<Inst>* inst_pool;
+    /// Memory resource for instructions and edges
+    std::pmr::memory_resource* memory;
 
     /// List of instructions in this block
     InstructionList instructions;
 
     /// Block immediate predecessors
-    std::vector<Block*> imm_predecessors;
+    std::pmr::vector<Block*> imm_predecessors;
     /// Block immediate successors
-    std::vector<Block*> imm_successors;
+    std::pmr::vector<Block*> imm_successors;
 
-    /// Intrusively store the value of a register in the block.
-    std::array<Value, NUM_REGS> ssa_reg_values;
     /// Intrusively store if the block is sealed in the SSA pass.
     bool is_ssa_sealed{false};
 
@@ -0,0 +1,248 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2026 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <algorithm>
+#include <utility>
+
+#include <shader_compiler/exception.h>
+#include <shader_compiler/frontend/ir/basic_block.h>
+#include <shader_compiler/frontend/ir/control_flow_analysis.h>
+#include <shader_compiler/frontend/ir/program.h>
+
+namespace Shader::IR {
+
+DominatorTree::DominatorTree(const Program& program)
+    : rpo_blocks(program.post_order_blocks.rbegin(), program.post_order_blocks.rend()),
+      nodes(NumBlockOrders(program)) {
+    const u32 num_blocks{static_cast<u32>(rpo_blocks.size())};
+    if (num_blocks == 0) {
+        return;
+    }
+    for (u32 index = 0; index < num_blocks; ++index) {
+        nodes[rpo_blocks[index]->GetOrder()].rpo_number = index;
+    }
+    // Immediate dominators are computed as reverse post order numbers, walking up the tree
+    // towards the entry always decreases them
+    std::vector<u32> idoms(num_blocks, UNREACHABLE);
+    idoms[0] = 0;
+    const auto intersect{[&](u32 a, u32 b) {
+        while (a != b) {
+            while (a > b) {
+                a = idoms[a];
+            }
+            while (b > a) {
+                b = idoms[b];
+            }
+        }
+        return a;
+    }};
+    bool changed{true};
+    while (changed) {
+        changed = false;
+        for (u32 index = 1; index < num_blocks; ++index) {
+            u32 new_idom{UNREACHABLE};
+            for (const Block* const pred : rpo_blocks[index]->ImmPredecessors()) {
+                const u32 pred_number{RpoNumber(pred)};
+                if (pred_number == UNREACHABLE || idoms[pred_number] == UNREACHABLE) {
+                    continue;
+                }
+                new_idom = new_idom == UNREACHABLE ? pred_number : intersect(pred_number, new_idom);
+            }
+            if (idoms[index] != new_idom) {
+                idoms[index] = new_idom;
+                changed = true;
+            }
+        }
+    }
+
+    // Children are laid out contiguously per parent, visiting blocks in reverse post order keeps
+    // every list sorted
+    for (u32 index = 1; index < num_blocks; ++index) {
+        ++nodes[rpo_blocks[idoms[index]]->GetOrder()].num_children;
+    }
+    u32 offset{};
+    for (Block* const block : rpo_blocks) {
+        Node& node{nodes[block->GetOrder()]};
+        node.children_offset = offset;
+        offset += node.num_children;
+        node.num_children = 0;
+    }
+    children.resize(offset);
+    for (u32 index = 1; index < num_blocks; ++index) {
+        Block* const idom{rpo_blocks[idoms[index]]};
+        Node& parent{nodes[idom->GetOrder()]};
+        children[parent.children_offset + parent.num_children++] = rpo_blocks[index];
+        nodes[rpo_blocks[index]->GetOrder()].idom = idom;
+    }
+
+    // Number the tree so that dominance is a nesting test of the intervals
+    u32 counter{};
+    std::vector<std::pair<Block*, u32>> stack{{rpo_blocks.front(), 0}};
+    nodes[rpo_blocks.front()->GetOrder()].tree_enter = counter++;
+    while (!stack.empty()) {
+        const auto [block, next_child]{stack.back()};
+        Node& node{nodes[block->GetOrder()]};
+        if (next_child == node.num_children) {
+            node.tree_exit = counter++;
+            stack.pop_back();
+            continue;
+        }
+        ++stack.back().second;
+        Block* const child{children[node.children_offset + next_child]};
+        nodes[child->GetOrder()].tree_enter = counter++;
+        stack.emplace_back(child, 0);
+    }
+
+    // Frontiers are sized on a first walk and filled on a second one, a join block is only added
+    // once to each frontier as the walks for all of its predecessors happen back to back
+    std::vector<u32> last_join(num_blocks, UNREACHABLE);
+    const auto walk_frontiers{[&](auto&& add) {
+        for (u32 index = 0; index < num_blocks; ++index) {
+            Block* const block{rpo_blocks[index]};
+            if (block->ImmPredecessors().size() < 2) {
+                continue;
+            }
+            for (const Block* const pred : block->ImmPredecessors()) {
+                u32 runner{RpoNumber(pred)};
+                if (runner == UNREACHABLE) {
+                    continue;
+                }
+                while (runner != idoms[index] && last_join[runner] != index) {
+                    last_join[runner] = index;
+                    add(nodes[rpo_blocks[runner]->GetOrder()], block);
+                    runner = idoms[runner];
+                }
+            }
+        }
+    }};
+    walk_frontiers([](Node& node, Block*) { ++node.frontier_size; });
+    offset = 0;
+    for (Block* const block : rpo_blocks) {
+        Node& node{nodes[block->GetOrder()]};
+        node.frontier_offset = offset;
+        offset += node.frontier_size;
+        node.frontier_size = 0;
+    }
+    frontiers.resize(offset);
+    std::ranges::fill(last_join, UNREACHABLE);
+    walk_frontiers([this](Node& node, Block* join) {
+        frontiers[node.frontier_offset + node.frontier_size++] = join;
+    });
+}
+
+const DominatorTree::Node* DominatorTree::Find(const Block* block) const noexcept {
+    const u32 order{block->GetOrder()};
+    if (order >= nodes.size() || nodes[order].rpo_number == UNREACHABLE) {
+        return nullptr;
+    }
+    return &nodes[order];
+}
+
+u32 DominatorTree::RpoNumber(const Block* block) const noexcept {
+    const Node* const node{Find(block)};
+    return node ? node->rpo_number : UNREACHABLE;
+}
+
+Block* DominatorTree::ImmediateDominator(const Block* block) const noexcept {
+    const Node* const node{Find(block)};
+    return node ? node->idom : nullptr;
+}
+
+bool DominatorTree::Dominates(const Block* a, const Block* b) const noexcept {
+    const Node* const a_node{Find(a)};
+    const Node* const b_node{Find(b)};
+    if (!a_node || !b_node) {
+        return false;
+    }
+    return a_node->tree_enter <= b_node->tree_enter && b_node->tree_exit <= a_node->tree_exit;
+}
+
+std::span<Block* const> DominatorTree::Children(const Block* block) const noexcept {
+    const Node* const node{Find(block)};
+    if (!node) {
+        return {};
+    }
+    return std::span{children}.subspan(node->children_offset, node->num_children);
+}
+
+std::span<Block* const> DominatorTree::DominanceFrontier(const Block* block) const noexcept {
+    const Node* const node{Find(block)};
+    if (!node) {
+        return {};
+    }
+    return std::span{frontiers}.subspan(node->frontier_offset, node->frontier_size);
+}
+
+LoopNest::LoopNest(const Program& program) : innermost_loops(NumBlockOrders(program)) {
+    const AbstractSyntaxList& syntax_list{program.syntax_list};
+    // Loops are referenced by their children, the storage must not move while they're found
+    loops.reserve(static_cast<size_t>(
+        std::ranges::count_if(syntax_list, [](const AbstractSyntaxNode& node) {
+            return node.type == AbstractSyntaxNode::Type::Loop;
+        })));
+    std::vector<u32> stack;
+    for (size_t index = 0; index < syntax_list.size(); ++index) {
+        const AbstractSyntaxNode& node{syntax_list[index]};
+        switch (node.type) {
+        case AbstractSyntaxNode::Type::Block:
+            if (!stack.empty()) {
+                innermost_loops[node.data.block->GetOrder()] = stack.back() + 1;
+            }
+            break;
+        case AbstractSyntaxNode::Type::Loop: {
+            // The header is emitted right before the loop node, outside of the loop body
+            if (index == 0 || syntax_list[index - 1].type != AbstractSyntaxNode::Type::Block) {
+                throw LogicError("Loop node is not preceded by its header block");
+            }
+            Block* const header{syntax_list[index - 1].data.block};
+            loops.push_back(Loop{
+                .header = header,
+                .continue_block = node.data.loop.continue_block,
+                .merge = node.data.loop.merge,
+                .parent = stack.empty() ? nullptr : &loops[stack.back()],
+                .depth = static_cast<u32>(stack.size() + 1),
+            });
+            stack.push_back(static_cast<u32>(loops.size() - 1));
+            innermost_loops[header->GetOrder()] = stack.back() + 1;
+            break;
+        }
+        case AbstractSyntaxNode::Type::Repeat:
+            if (stack.empty()) {
+                throw LogicError("Repeat node without a loop");
+            }
+            stack.pop_back();
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+const Loop* LoopNest::LoopOf(const Block* block) const noexcept {
+    const u32 order{block->GetOrder()};
+    if (order >= innermost_loops.size() || innermost_loops[order] == 0) {
+        return nullptr;
+    }
+    return &loops[innermost_loops[order] - 1];
+}
+
+bool LoopNest::Contains(const Loop& loop, const Block* block) noexcept {
+    const u32 order{block->GetOrder()};
+    return loop.header->GetOrder() <= order && order <= loop.continue_block->GetOrder();
+}
+
+const DominatorTree& AnalysisManager::Dominators(const Program& program) {
+    if (!dominator_tree) {
+        dominator_tree.emplace(program);
+    }
+    return *dominator_tree;
+}
+
+const LoopNest& AnalysisManager::Loops(const Program& program) {
+    if (!loop_nest) {
+        loop_nest.emplace(program);
+    }
+    return *loop_nest;
+}
+
+} // namespace Shader::IR
@@ -0,0 +1,149 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2026 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <shader_compiler/common/common_types.h>
+
+namespace Shader::IR {
+
+class Block;
+struct Program;
+
+/**
+ * @brief The dominator tree of the reachable blocks of a program along with their reverse post
+ * order numbering and dominance frontiers
+ * @note Blocks are identified by their order, dominance is computed with the iterative algorithm
+ * from "A Simple, Fast Dominance Algorithm" (Cooper, Harvey, Kennedy) which converges in two
+ * passes over the reducible graphs the structurizer produces
+ */
+class DominatorTree {
+public:
+    static constexpr u32 UNREACHABLE{~0U};
+
+    explicit DominatorTree(const Program& program);
+
+    /// Blocks in reverse post order, a block always appears before the blocks it dominates
+    [[nodiscard]] std::span<Block* const> ReversePostOrder() const noexcept {
+        return rpo_blocks;
+    }
+
+    /// The position of a block in reverse post order or UNREACHABLE
+    [[nodiscard]] u32 RpoNumber(const Block* block) const noexcept;
+
+    [[nodiscard]] bool IsReachable(const Block* block) const noexcept {
+        return RpoNumber(block) != UNREACHABLE;
+    }
+
+    /// The immediate dominator of a block, null for the entry block and unreachable blocks
+    [[nodiscard]] Block* ImmediateDominator(const Block* block) const noexcept;
+
+    /// Checks if every path from the entry to b goes through a, a block dominates itself, O(1)
+    [[nodiscard]] bool Dominates(const Block* a, const Block* b) const noexcept;
+
+    /// Blocks immediately dominated by a block, in reverse post order
+    [[nodiscard]] std::span<Block* const> Children(const Block* block) const noexcept;
+
+    /// Blocks where the dominance of a block ends, phis for its definitions are placed there
+    [[nodiscard]] std::span<Block* const> DominanceFrontier(const Block* block) const noexcept;
+
+private:
+    struct Node {
+        Block* idom{};
+        u32 rpo_number{UNREACHABLE};
+        /// Preorder and postorder numbers of the node in the tree, they nest for dominated nodes
+        u32 tree_enter{};
+        u32 tree_exit{};
+        u32 children_offset{};
+        u32 num_children{};
+        u32 frontier_offset{};
+        u32 frontier_size{};
+    };
+
+    [[nodiscard]] const Node* Find(const Block* block) const noexcept;
+
+    std::vector<Block*> rpo_blocks;
+    std::vector<Node> nodes;
+    std::vector<Block*> children;
+    std::vector<Block*> frontiers;
+};
+
+/// A structured loop of the abstract syntax list
+struct Loop {
+    Block* header;         ///< The first block of the loop, the back edge branches to it
+    Block* continue_block; ///< The last block of the loop, it holds the back edge
+    Block* merge;          ///< The block reached once the loop exits
+    const Loop* parent;    ///< The innermost loop containing this one, null for outermost loops
+    u32 depth;             ///< One for outermost loops
+};
+
+/**
+ * @brief The loops of a program found from the Loop and Repeat nodes of its abstract syntax list
+ * @note Blocks are ordered by their position in the abstract syntax list, so the blocks of a loop
+ * are exactly the ones between its header and its continue block
+ */
+class LoopNest {
+public:
+    explicit LoopNest(const Program& program);
+
+    /// Every loop, outer loops come before the loops they contain
+    [[nodiscard]] std::span<const Loop> Loops() const noexcept {
+        return loops;
+    }
+
+    /// The innermost loop containing a block, null if the block isn't in a loop
+    [[nodiscard]] const Loop* LoopOf(const Block* block) const noexcept;
+
+    /// The number of loops containing a block
+    [[nodiscard]] u32 LoopDepth(const Block* block) const noexcept {
+        const Loop* const loop{LoopOf(block)};
+        return loop ? loop->depth : 0;
+    }
+
+    /// Checks if a block is inside of a loop, including nested loops
+    [[nodiscard]] static bool Contains(const Loop& loop, const Block* block) noexcept;
+
+private:
+    std::vector<Loop> loops;
+    /// Index of the innermost loop of each block plus one, zero for blocks outside of loops
+    std::vector<u32> innermost_loops;
+};
+
+/**
+ * @brief Caches control flow analyses of a program, they're computed on the first request
+ * @note Passes which add or remove blocks or edges must invalidate the analyses, the pass manager
+ * does so after running passes declaring it
+ */
+class AnalysisManager {
+public:
+    AnalysisManager() = default;
+
+    /// Copies start out empty as the cached loops link to each other
+    AnalysisManager(const AnalysisManager&) noexcept {}
+    AnalysisManager& operator=(const AnalysisManager&) noexcept {
+        InvalidateControlFlow();
+        return *this;
+    }
+
+    AnalysisManager(AnalysisManager&&) noexcept = default;
+    AnalysisManager& operator=(AnalysisManager&&) noexcept = default;
+
+    [[nodiscard]] const DominatorTree& Dominators(const Program& program);
+
+    [[nodiscard]] const LoopNest& Loops(const Program& program);
+
+    void InvalidateControlFlow() noexcept {
+        dominator_tree.reset();
+        loop_nest.reset();
+    }
+
+private:
+    std::optional<DominatorTree> dominator_tree;
+    std::optional<LoopNest> loop_nest;
+};
+
+} // namespace Shader::IR
@@ -11,47 +11,23 @@
 #include <shader_compiler/frontend/ir/value.h>
 
 namespace Shader::IR {
-namespace {
-void CheckPseudoInstruction(IR::Inst* inst, IR::Opcode opcode) {
-    if (inst && inst->GetOpcode() != opcode) {
-        throw LogicError("Invalid pseudo-instruction");
-    }
-}
-
-void SetPseudoInstruction(IR::Inst*& dest_inst, IR::Inst* pseudo_inst) {
-    if (dest_inst) {
-        throw LogicError("Only one of each type of pseudo-op allowed");
-    }
-    dest_inst = pseudo_inst;
-}
-
-void RemovePseudoInstruction(IR::Inst*& inst, IR::Opcode expected_opcode) {
-    if (inst->GetOpcode() != expected_opcode) {
-        throw LogicError("Undoing use of invalid pseudo-op");
-    }
-    inst = nullptr;
-}
-
-void AllocAssociatedInsts(std::unique_ptr<AssociatedInsts>& associated_insts) {
-    if (!associated_insts) {
-        associated_insts = std::make_unique<AssociatedInsts>();
-    }
-}
-} // Anonymous namespace
 
-Inst::Inst(IR::Opcode op_, u32 flags_) noexcept : op{op_}, flags{flags_} {
+Inst::Inst(IR::Opcode op_, u32 flags_, std::pmr::memory_resource* memory_)
+    : op{op_}, flags{flags_}, uses{reinterpret_cast<uintptr_t>(memory_)} {
     if (op == Opcode::Phi) {
-        std::construct_at(&phi_args);
+        phi_args = std::pmr::polymorphic_allocator<PhiArgs>{memory_}.new_object<PhiArgs>();
     } else {
-        std::construct_at(&args);
+        ConstructArgs(op);
     }
 }
 
-Inst::Inst(const Inst& base) : op{base.op}, flags{base.flags} {
+Inst::Inst(const Inst& base)
+    : op{base.op}, flags{base.flags},
+      uses{reinterpret_cast<uintptr_t>(base.Memory())} {
     if (base.op == Opcode::Phi) {
         throw NotImplementedException("Copying phi node");
     }
-    std::construct_at(&args);
+    ConstructArgs(op);
     const size_t num_args{base.NumArgs()};
     for (size_t index = 0; index < num_args; ++index) {
         SetArg(index, base.Arg(index));
@@ -60,10 +36,32 @@ Inst::Inst(const Inst& base) : op{base.op}, flags{base.flags} {
 
 Inst::~Inst() {
     if (op == Opcode::Phi) {
-        std::destroy_at(&phi_args);
+        std::pmr::polymorphic_allocator<PhiArgs>{Memory()}.delete_object(phi_args);
+    } else {
+        DestroyArgs();
+    }
+}
+
+void Inst::ConstructArgs(IR::Opcode opcode) {
+    if (HasWideArgs(opcode)) {
+        wide_args = std::pmr::polymorphic_allocator<Value>{Memory()}.allocate(NUM_WIDE_ARGS);
+        std::uninitialized_value_construct_n(wide_args, NUM_WIDE_ARGS);
     } else {
-        std::destroy_at(&args);
+        std::construct_at(&args);
+    }
+}
+
+void Inst::DestroyArgs() {
+    if (HasWideArgs(op)) {
+        std::pmr::polymorphic_allocator<Value>{Memory()}.deallocate(wide_args, NUM_WIDE_ARGS);
+    }
+}
+
+std::pmr::memory_resource* Inst::Memory() const noexcept {
+    if (const UseNode* const node{FirstUse()}) {
+        return node->memory;
     }
+    return reinterpret_cast<std::pmr::memory_resource*>(uses);
 }
 
 bool Inst::MayHaveSideEffects() const noexcept {
@@ -251,36 +249,38 @@ bool Inst::AreAllArgsImmediates() const {
     if (op == Opcode::Phi) {
         throw LogicError("Testing for all arguments are immediates on phi instruction");
     }
-    return std::all_of(args.begin(), args.begin() + NumArgs(),
-                       [](const IR::Value& value) { return value.IsImmediate(); });
+    const Value* const storage{ArgStorage(op)};
+    return std::all_of(storage, storage + NumArgs(),
+                       [](const IR::Value& slot) { return LoadArg(slot).IsImmediate(); });
 }
 
-Inst* Inst::GetAssociatedPseudoOperation(IR::Opcode opcode) {
-    if (!associated_insts) {
-        return nullptr;
+bool Inst::HasAssociatedPseudoOperation() const noexcept {
+    for (const Inst* const user : Users()) {
+        if (user->IsPseudoInstruction()) {
+            return true;
+        }
     }
+    return false;
+}
+
+Inst* Inst::GetAssociatedPseudoOperation(IR::Opcode opcode) {
     switch (opcode) {
     case Opcode::GetZeroFromOp:
-        CheckPseudoInstruction(associated_insts->zero_inst, Opcode::GetZeroFromOp);
-        return associated_insts->zero_inst;
     case Opcode::GetSignFromOp:
-        CheckPseudoInstruction(associated_insts->sign_inst, Opcode::GetSignFromOp);
-        return associated_insts->sign_inst;
     case Opcode::GetCarryFromOp:
-        CheckPseudoInstruction(associated_insts->carry_inst, Opcode::GetCarryFromOp);
-        return associated_insts->carry_inst;
     case Opcode::GetOverflowFromOp:
-        CheckPseudoInstruction(associated_insts->overflow_inst, Opcode::GetOverflowFromOp);
-        return associated_insts->overflow_inst;
     case Opcode::GetSparseFromOp:
-        CheckPseudoInstruction(associated_insts->sparse_inst, Opcode::GetSparseFromOp);
-        return associated_insts->sparse_inst;
     case Opcode::GetInBoundsFromOp:
-        CheckPseudoInstruction(associated_insts->in_bounds_inst, Opcode::GetInBoundsFromOp);
-        return associated_insts->in_bounds_inst;
+        break;
     default:
         throw InvalidArgument("{} is not a pseudo-instruction", opcode);
     }
+    for (Inst* const user : Users()) {
+        if (user->op == opcode) {
+            return user;
+        }
+    }
+    return nullptr;
 }
 
 IR::Type Inst::Type() const {
@@ -295,42 +295,44 @@ void Inst::SetArg(size_t index, Value value) {
     if (index >= NumArgs()) {
         throw InvalidArgument("Out of bounds argument index {} in opcode {}", index, op);
     }
-    const IR::Value arg{Arg(index)};
-    if (!arg.IsImmediate()) {
-        UndoUse(arg);
-    }
-    if (!value.IsImmediate()) {
-        Use(value);
-    }
-    if (op == Opcode::Phi) {
-        phi_args[index].second = value;
-    } else {
-        args[index] = value;
-    }
+    // Identities are looked through so that they never gain users and chains can't form
+    value = value.Resolve();
+    Value& slot{op == Opcode::Phi ? (*phi_args)[index].second : ArgStorage(op)[index]};
+    ReleaseArg(slot);
+    slot = StoreArg(value);
 }
 
 Block* Inst::PhiBlock(size_t index) const {
     if (op != Opcode::Phi) {
         throw LogicError("{} is not a Phi instruction", op);
     }
-    if (index >= phi_args.size()) {
+    if (index >= phi_args->size()) {
         throw InvalidArgument("Out of bounds argument index {} in phi instruction");
     }
-    return phi_args[index].first;
+    return (*phi_args)[index].first;
+}
+
+void Inst::AddPhiOperand(Block* predecessor, const Value& operand) {
+    phi_args->emplace_back(predecessor, StoreArg(operand.Resolve()));
 }
 
-void Inst::AddPhiOperand(Block* predecessor, const Value& value) {
-    if (!value.IsImmediate()) {
-        Use(value);
+void Inst::RemovePhiOperand(Block* predecessor) {
+    if (op != Opcode::Phi) {
+        throw LogicError("{} is not a Phi instruction", op);
+    }
+    const auto it{std::ranges::find(*phi_args, predecessor, &std::pair<Block*, Value>::first)};
+    if (it == phi_args->end()) {
+        throw InvalidArgument("Block is not a phi operand");
     }
-    phi_args.emplace_back(predecessor, value);
+    ReleaseArg(it->second);
+    phi_args->erase(it);
 }
 
 void Inst::OrderPhiArgs() {
     if (op != Opcode::Phi) {
         throw LogicError("{} is not a Phi instruction", op);
     }
-    std::sort(phi_args.begin(), phi_args.end(),
+    std::sort(phi_args->begin(), phi_args->end(),
               [](const std::pair<Block*, Value>& a, const std::pair<Block*, Value>& b) {
                   return a.first->GetOrder() < b.first->GetOrder();
               });
@@ -343,32 +345,69 @@ void Inst::Invalidate() {
 
 void Inst::ClearArgs() {
     if (op == Opcode::Phi) {
-        for (auto& pair : phi_args) {
-            IR::Value& value{pair.second};
-            if (!value.IsImmediate()) {
-                UndoUse(value);
-            }
+        for (const auto& pair : *phi_args) {
+            ReleaseArg(pair.second);
         }
-        phi_args.clear();
+        phi_args->clear();
     } else {
-        for (auto& value : args) {
-            if (!value.IsImmediate()) {
-                UndoUse(value);
-            }
+        Value* const storage{ArgStorage(op)};
+        const size_t num_slots{HasWideArgs(op) ? NUM_WIDE_ARGS : NUM_INLINE_ARGS};
+        for (size_t index = 0; index < num_slots; ++index) {
+            ReleaseArg(storage[index]);
         }
         // Reset arguments to null
         // std::memset was measured to be faster on MSVC than ranges:fill
-        std::memset(reinterpret_cast<char*>(&args), 0, sizeof(args));
+        std::memset(reinterpret_cast<char*>(storage), 0, num_slots * sizeof(Value));
     }
 }
 
 void Inst::ReplaceUsesWith(Value replacement) {
+    replacement = replacement.Resolve();
     Invalidate();
-    ReplaceOpcode(Opcode::Identity);
-    if (!replacement.IsImmediate()) {
-        Use(replacement);
+
+    // Reroute every user to the replacement, when both instructions share a memory resource the
+    // nodes are spliced into the user list of the replacement and arguments keep pointing to them
+    Inst* const replacement_inst{replacement.IsImmediate() ? nullptr : replacement.Inst()};
+    std::pmr::memory_resource* const memory{Memory()};
+    UseNode* const first{FirstUse()};
+    int num_moved{};
+    uses = reinterpret_cast<uintptr_t>(memory);
+    if (replacement_inst && replacement_inst->Memory() == memory) {
+        UseNode* last{};
+        for (UseNode* node{first}; node; node = node->next) {
+            node->value = replacement;
+            last = node;
+            ++num_moved;
+        }
+        if (last) {
+            last->next = replacement_inst->FirstUse();
+            if (last->next) {
+                last->next->prev = last;
+            }
+            replacement_inst->uses = reinterpret_cast<uintptr_t>(first) | IS_USE_BIT;
+            replacement_inst->use_count += num_moved;
+        }
+    } else {
+        for (UseNode* node{first}; node; ++num_moved) {
+            UseNode* const next{node->next};
+            node->user->RedirectArg(node, replacement);
+            node = next;
+        }
+    }
+    use_count -= num_moved;
+}
+
+void Inst::RedirectArg(UseNode* node, const Value& new_value) {
+    const Value old_slot{EncodeUse(node)};
+    Value* slot{};
+    if (op == Opcode::Phi) {
+        const auto it{std::ranges::find(*phi_args, old_slot, &std::pair<Block*, Value>::second)};
+        slot = &it->second;
+    } else {
+        slot = std::find(ArgStorage(op), ArgStorage(op) + NumArgsOf(op), old_slot);
     }
-    args[0] = replacement;
+    std::pmr::polymorphic_allocator<UseNode>{node->memory}.deallocate(node, 1);
+    *slot = new_value.IsImmediate() ? new_value : EncodeUse(new_value.Inst()->AddUser(this));
 }
 
 void Inst::ReplaceOpcode(IR::Opcode opcode) {
@@ -377,80 +416,75 @@ void Inst::ReplaceOpcode(IR::Opcode opcode) {
     }
     if (op == Opcode::Phi) {
         // Transition out of phi arguments into non-phi
-        std::destroy_at(&phi_args);
-        std::construct_at(&args);
+        std::pmr::polymorphic_allocator<PhiArgs>{Memory()}.delete_object(phi_args);
+        ConstructArgs(opcode);
+    } else if (HasWideArgs(op) != HasWideArgs(opcode)) {
+        // Move the arguments between the inline and the out-of-line storage, arguments which don't
+        // fit in the new storage are released
+        std::array<Value, NUM_WIDE_ARGS> old_args{};
+        const size_t num_old_slots{HasWideArgs(op) ? NUM_WIDE_ARGS : NUM_INLINE_ARGS};
+        std::copy_n(ArgStorage(op), num_old_slots, old_args.begin());
+        DestroyArgs();
+        ConstructArgs(opcode);
+        const size_t num_new_slots{HasWideArgs(opcode) ? NUM_WIDE_ARGS : NUM_INLINE_ARGS};
+        std::copy_n(old_args.begin(), std::min(num_old_slots, num_new_slots),
+                    ArgStorage(opcode));
+        for (size_t index = num_new_slots; index < num_old_slots; ++index) {
+            ReleaseArg(old_args[index]);
+        }
     }
     op = opcode;
 }
 
-void Inst::Use(const Value& value) {
+Value Inst::StoreArg(const Value& value) {
+    // Identities of immediates count as immediates, so their uses aren't tracked
+    if (value.IsImmediate()) {
+        return value;
+    }
     Inst* const inst{value.Inst()};
-    ++inst->use_count;
-
-    std::unique_ptr<AssociatedInsts>& assoc_inst{inst->associated_insts};
-    switch (op) {
-    case Opcode::GetZeroFromOp:
-        AllocAssociatedInsts(assoc_inst);
-        SetPseudoInstruction(assoc_inst->zero_inst, this);
-        break;
-    case Opcode::GetSignFromOp:
-        AllocAssociatedInsts(assoc_inst);
-        SetPseudoInstruction(assoc_inst->sign_inst, this);
-        break;
-    case Opcode::GetCarryFromOp:
-        AllocAssociatedInsts(assoc_inst);
-        SetPseudoInstruction(assoc_inst->carry_inst, this);
-        break;
-    case Opcode::GetOverflowFromOp:
-        AllocAssociatedInsts(assoc_inst);
-        SetPseudoInstruction(assoc_inst->overflow_inst, this);
-        break;
-    case Opcode::GetSparseFromOp:
-        AllocAssociatedInsts(assoc_inst);
-        SetPseudoInstruction(assoc_inst->sparse_inst, this);
-        break;
-    case Opcode::GetInBoundsFromOp:
-        AllocAssociatedInsts(assoc_inst);
-        SetPseudoInstruction(assoc_inst->in_bounds_inst, this);
-        break;
-    default:
-        break;
+    if (IsPseudoInstruction() && inst->GetAssociatedPseudoOperation(op)) {
+        throw LogicError("Only one of each type of pseudo-op allowed");
     }
+    return EncodeUse(inst->AddUser(this));
 }
 
-void Inst::UndoUse(const Value& value) {
-    Inst* const inst{value.Inst()};
+void Inst::ReleaseArg(const Value& slot) noexcept {
+    if (slot.GetTag() != Value::Tag::Use) {
+        return;
+    }
+    UseNode* const node{UsePointer(slot)};
+    Inst* const inst{node->value.InstPointer()};
+    if (node->prev) {
+        node->prev->next = node->next;
+    } else if (node->next) {
+        inst->uses = reinterpret_cast<uintptr_t>(node->next) | IS_USE_BIT;
+    } else {
+        inst->uses = reinterpret_cast<uintptr_t>(node->memory);
+    }
+    if (node->next) {
+        node->next->prev = node->prev;
+    }
     --inst->use_count;
+    std::pmr::polymorphic_allocator<UseNode>{node->memory}.deallocate(node, 1);
+}
 
-    std::unique_ptr<AssociatedInsts>& assoc_inst{inst->associated_insts};
-    switch (op) {
-    case Opcode::GetZeroFromOp:
-        AllocAssociatedInsts(assoc_inst);
-        RemovePseudoInstruction(assoc_inst->zero_inst, Opcode::GetZeroFromOp);
-        break;
-    case Opcode::GetSignFromOp:
-        AllocAssociatedInsts(assoc_inst);
-        RemovePseudoInstruction(assoc_inst->sign_inst, Opcode::GetSignFromOp);
-        break;
-    case Opcode::GetCarryFromOp:
-        AllocAssociatedInsts(assoc_inst);
-        RemovePseudoInstruction(assoc_inst->carry_inst, Opcode::GetCarryFromOp);
-        break;
-    case Opcode::GetOverflowFromOp:
-        AllocAssociatedInsts(assoc_inst);
-        RemovePseudoInstruction(assoc_inst->overflow_inst, Opcode::GetOverflowFromOp);
-        break;
-    case Opcode::GetSparseFromOp:
-        AllocAssociatedInsts(assoc_inst);
-        RemovePseudoInstruction(assoc_inst->sparse_inst, Opcode::GetSparseFromOp);
-        break;
-    case Opcode::GetInBoundsFromOp:
-        AllocAssociatedInsts(assoc_inst);
-        RemovePseudoInstruction(assoc_inst->in_bounds_inst, Opcode::GetInBoundsFromOp);
-        break;
-    default:
-        break;
+Inst::UseNode* Inst::AddUser(Inst* user) {
+    std::pmr::memory_resource* const memory{Memory()};
+    UseNode* const node{std::pmr::polymorphic_allocator<UseNode>{memory}.allocate(1)};
+    UseNode* const first{FirstUse()};
+    std::construct_at(node, UseNode{
+                                .user = user,
+                                .value = Value{this},
+                                .prev = nullptr,
+                                .next = first,
+                                .memory = memory,
+                            });
+    if (first) {
+        first->prev = node;
     }
+    uses = reinterpret_cast<uintptr_t>(node) | IS_USE_BIT;
+    ++use_count;
+    return node;
 }
 
 } // namespace Shader::IR
@@ -1,6 +1,7 @@
 // SPDX-FileCopyrightText: Copyright 2021 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
 #include <map>
 #include <string>
 
@@ -12,6 +13,20 @@
 
 namespace Shader::IR {
 
+size_t NumBlockOrders(const Program& program) {
+    u32 num_orders{};
+    for (const Block* const block : program.blocks) {
+        num_orders = std::max(num_orders, block->GetOrder() + 1);
+        for (const Block* const pred : block->ImmPredecessors()) {
+            num_orders = std::max(num_orders, pred->GetOrder() + 1);
+        }
+    }
+    for (const Block* const block : program.post_order_blocks) {
+        num_orders = std::max(num_orders, block->GetOrder() + 1);
+    }
+    return num_orders;
+}
+
 std::string DumpProgram(const Program& program) {
     size_t index{0};
     std::map<const IR::Inst*, size_t> inst_to_index;
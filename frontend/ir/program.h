@@ -8,6 +8,7 @@
 
 #include <shader_compiler/frontend/ir/abstract_syntax_list.h>
 #include <shader_compiler/frontend/ir/basic_block.h>
+#include <shader_compiler/frontend/ir/control_flow_analysis.h>
 #include <shader_compiler/program_header.h>
 #include <shader_compiler/shader_info.h>
 #include <shader_compiler/stage.h>
@@ -27,8 +28,16 @@ struct Program {
     u32 local_memory_size{};
     u32 shared_memory_size{};
     bool is_geometry_passthrough{};
+    /// Dominance and loop information, computed when a pass first asks for it
+    AnalysisManager analyses;
 };
 
+/**
+ * @brief The amount of block orders in use, tables indexed by block order must be this large
+ * @note Predecessors are included as unreachable blocks removed from the program may still be one
+ */
+[[nodiscard]] size_t NumBlockOrders(const Program& program);
+
 [[nodiscard]] std::string DumpProgram(const Program& program);
 
 } // namespace Shader::IR
@@ -5,96 +5,103 @@
 
 namespace Shader::IR {
 
-Value::Value(IR::Inst* value) noexcept : type{Type::Opaque}, inst{value} {}
+Value::Value(IR::Inst* value) noexcept {
+    raw = reinterpret_cast<u64>(value) | static_cast<u64>(Tag::Opaque);
+}
 
-Value::Value(IR::Reg value) noexcept : type{Type::Reg}, reg{value} {}
+Value::Value(IR::Reg value) noexcept : Value{Encode(Tag::Reg, static_cast<u64>(value))} {}
 
-Value::Value(IR::Pred value) noexcept : type{Type::Pred}, pred{value} {}
+Value::Value(IR::Pred value) noexcept : Value{Encode(Tag::Pred, static_cast<u64>(value))} {}
 
-Value::Value(IR::Attribute value) noexcept : type{Type::Attribute}, attribute{value} {}
+Value::Value(IR::Attribute value) noexcept
+    : Value{Encode(Tag::Attribute, static_cast<u64>(value))} {}
 
-Value::Value(IR::Patch value) noexcept : type{Type::Patch}, patch{value} {}
+Value::Value(IR::Patch value) noexcept : Value{Encode(Tag::Patch, static_cast<u64>(value))} {}
 
-Value::Value(bool value) noexcept : type{Type::U1}, imm_u1{value} {}
+Value::Value(bool value) noexcept : Value{Encode(Tag::U1, value ? 1 : 0)} {}
 
-Value::Value(u8 value) noexcept : type{Type::U8}, imm_u8{value} {}
+Value::Value(u8 value) noexcept : Value{Encode(Tag::U8, value)} {}
 
-Value::Value(u16 value) noexcept : type{Type::U16}, imm_u16{value} {}
+Value::Value(u16 value) noexcept : Value{Encode(Tag::U16, value)} {}
 
-Value::Value(u32 value) noexcept : type{Type::U32}, imm_u32{value} {}
+Value::Value(u32 value) noexcept : Value{Encode(Tag::U32, value)} {}
 
-Value::Value(s32 value) noexcept : type{Type::S32}, imm_s32{value} {}
+Value::Value(s32 value) noexcept : Value{Encode(Tag::S32, static_cast<u32>(value))} {}
 
-Value::Value(f32 value) noexcept : type{Type::F32}, imm_f32{value} {}
+Value::Value(f32 value) noexcept : Value{Encode(Tag::F32, Common::BitCast<u32>(value))} {}
 
-Value::Value(u64 value) noexcept : type{Type::U64}, imm_u64{value} {}
+Value::Value(u64 value, std::pmr::memory_resource& memory)
+    : Value{Encode64(Tag::U64, value, memory)} {}
 
-Value::Value(f64 value) noexcept : type{Type::F64}, imm_f64{value} {}
+Value::Value(f64 value, std::pmr::memory_resource& memory)
+    : Value{Encode64(Tag::F64, Common::BitCast<u64>(value), memory)} {}
 
-IR::Type Value::Type() const noexcept {
-    if (IsPhi()) {
-        // The type of a phi node is stored in its flags
-        return inst->Flags<IR::Type>();
-    }
-    if (IsIdentity()) {
-        return inst->Arg(0).Type();
-    }
-    if (type == Type::Opaque) {
-        return inst->Type();
+Value Value::Encode64(Tag tag, u64 immediate, std::pmr::memory_resource& memory) {
+    static_assert(static_cast<u64>(Tag::U64Aligned) == static_cast<u64>(Tag::U64) + 1 &&
+                  static_cast<u64>(Tag::U64Wide) == static_cast<u64>(Tag::U64) + 2 &&
+                  static_cast<u64>(Tag::F64Aligned) == static_cast<u64>(Tag::F64) + 1 &&
+                  static_cast<u64>(Tag::F64Wide) == static_cast<u64>(Tag::F64) + 2);
+    const u64 base_tag{static_cast<u64>(tag)};
+    Value value;
+    if ((immediate >> (64 - TAG_BITS)) == 0) {
+        value.raw = (immediate << TAG_BITS) | base_tag;
+    } else if ((immediate & TAG_MASK) == 0) {
+        value.raw = immediate | (base_tag + 1);
+    } else {
+        WideImmediate* const storage{
+            std::pmr::polymorphic_allocator<WideImmediate>{&memory}.new_object<WideImmediate>(
+                WideImmediate{immediate})};
+        value.raw = reinterpret_cast<u64>(storage) | (base_tag + 2);
     }
-    return type;
+    return value;
 }
 
-bool Value::operator==(const Value& other) const {
-    if (type != other.type) {
-        return false;
+IR::Type Value::Type() const noexcept {
+    switch (GetTag()) {
+    case Tag::Void:
+    case Tag::Use:
+        return Type::Void;
+    case Tag::Opaque: {
+        IR::Inst* const inst{InstPointer()};
+        if (inst->GetOpcode() == Opcode::Phi) {
+            // The type of a phi node is stored in its flags
+            return inst->Flags<IR::Type>();
+        }
+        if (inst->GetOpcode() == Opcode::Identity) {
+            return inst->Arg(0).Type();
+        }
+        return inst->Type();
     }
-    switch (type) {
-    case Type::Void:
-        return true;
-    case Type::Opaque:
-        return inst == other.inst;
-    case Type::Reg:
-        return reg == other.reg;
-    case Type::Pred:
-        return pred == other.pred;
-    case Type::Attribute:
-        return attribute == other.attribute;
-    case Type::Patch:
-        return patch == other.patch;
-    case Type::U1:
-        return imm_u1 == other.imm_u1;
-    case Type::U8:
-        return imm_u8 == other.imm_u8;
-    case Type::U16:
-    case Type::F16:
-        return imm_u16 == other.imm_u16;
-    case Type::U32:
-    case Type::F32:
-    case Type::S32:
-        return imm_u32 == other.imm_u32;
-    case Type::U64:
-    case Type::F64:
-        return imm_u64 == other.imm_u64;
-    case Type::U32x2:
-    case Type::U32x3:
-    case Type::U32x4:
-    case Type::F16x2:
-    case Type::F16x3:
-    case Type::F16x4:
-    case Type::F32x2:
-    case Type::F32x3:
-    case Type::F32x4:
-    case Type::F64x2:
-    case Type::F64x3:
-    case Type::F64x4:
-        break;
+    case Tag::Reg:
+        return Type::Reg;
+    case Tag::Pred:
+        return Type::Pred;
+    case Tag::Attribute:
+        return Type::Attribute;
+    case Tag::Patch:
+        return Type::Patch;
+    case Tag::U1:
+        return Type::U1;
+    case Tag::U8:
+        return Type::U8;
+    case Tag::U16:
+        return Type::U16;
+    case Tag::U32:
+        return Type::U32;
+    case Tag::S32:
+        return Type::S32;
+    case Tag::F32:
+        return Type::F32;
+    case Tag::U64:
+    case Tag::U64Aligned:
+    case Tag::U64Wide:
+        return Type::U64;
+    case Tag::F64:
+    case Tag::F64Aligned:
+    case Tag::F64Wide:
+        return Type::F64;
     }
-    throw LogicError("Invalid type {}", type);
-}
-
-bool Value::operator!=(const Value& other) const {
-    return !operator==(other);
+    return Type::Void;
 }
 
 } // namespace Shader::IR
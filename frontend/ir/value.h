@@ -5,7 +5,9 @@
 
 #include <array>
 #include <cstring>
+#include <iterator>
 #include <memory>
+#include <memory_resource>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -29,8 +31,14 @@ namespace Shader::IR {
 class Block;
 class Inst;
 
-struct AssociatedInsts;
-
+/**
+ * @brief An instruction argument packed into a single word, the low bits tag the kind of value and
+ * the remaining bits hold the instruction pointer or the immediate
+ * @note 64-bit immediates are stored inline when they fit in the remaining bits or when their low
+ * bits are clear, any other 64-bit immediate is allocated out-of-line from the memory resource of
+ * the compilation. Values are compared by their raw word except out-of-line immediates, which are
+ * compared by content
+ */
 class Value {
 public:
     Value() noexcept = default;
@@ -45,8 +53,9 @@ public:
     explicit Value(u32 value) noexcept;
     explicit Value(s32 value) noexcept;
     explicit Value(f32 value) noexcept;
-    explicit Value(u64 value) noexcept;
-    explicit Value(f64 value) noexcept;
+    /// @param memory The resource wide immediates are allocated from, it must outlive the value
+    explicit Value(u64 value, std::pmr::memory_resource& memory);
+    explicit Value(f64 value, std::pmr::memory_resource& memory);
 
     [[nodiscard]] bool IsIdentity() const noexcept;
     [[nodiscard]] bool IsPhi() const noexcept;
@@ -71,28 +80,90 @@ public:
     [[nodiscard]] u64 U64() const;
     [[nodiscard]] f64 F64() const;
 
-    [[nodiscard]] bool operator==(const Value& other) const;
-    [[nodiscard]] bool operator!=(const Value& other) const;
+    [[nodiscard]] bool operator==(const Value& other) const noexcept {
+        return raw == other.raw || (IsWideImmediate() && GetTag() == other.GetTag() &&
+                                    Immediate64() == other.Immediate64());
+    }
+    [[nodiscard]] bool operator!=(const Value& other) const noexcept {
+        return !(*this == other);
+    }
+
+    /// The encoding of the value or the content of wide immediates, equal values have equal hashes
+    [[nodiscard]] u64 Hash() const noexcept {
+        return IsWideImmediate() ? Immediate64() ^ static_cast<u64>(GetTag()) : raw;
+    }
+
+    /// The amount of low bits tagging a value, instructions are aligned so these bits are clear
+    static constexpr u64 TAG_BITS{5};
 
 private:
-    IR::Type type{};
-    union {
-        IR::Inst* inst{};
-        IR::Reg reg;
-        IR::Pred pred;
-        IR::Attribute attribute;
-        IR::Patch patch;
-        bool imm_u1;
-        u8 imm_u8;
-        u16 imm_u16;
-        u32 imm_u32;
-        s32 imm_s32;
-        f32 imm_f32;
-        u64 imm_u64;
-        f64 imm_f64;
+    friend class Inst;
+
+    enum class Tag : u64 {
+        Void, //!< Must be zero so that a zeroed value is empty
+        Opaque,
+        Reg,
+        Pred,
+        Attribute,
+        Patch,
+        U1,
+        U8,
+        U16,
+        U32,
+        S32,
+        F32,
+        U64,        //!< Shifted above the tag
+        U64Aligned, //!< Stored in place, the low bits of the immediate are clear
+        U64Wide,    //!< Points to an immediate allocated from the compilation
+        F64,
+        F64Aligned,
+        F64Wide,
+        Use, //!< An argument slot of an instruction pointing to its use node, never leaves it
     };
+    static constexpr u64 TAG_MASK{(u64{1} << TAG_BITS) - 1};
+    static constexpr size_t TAG_ALIGNMENT{size_t{1} << TAG_BITS};
+
+    /**
+     * @brief Storage of an out-of-line 64-bit immediate, aligned so its address can be tagged
+     * @note Immediates aren't interned, every value gets its own copy from the memory of the block
+     * creating it. Blocks translated concurrently allocate from distinct shards so equal
+     * immediates can't share storage, wide immediates are compared and hashed by their contents
+     */
+    struct alignas(TAG_ALIGNMENT) WideImmediate {
+        u64 value;
+    };
+
+    [[nodiscard]] static Value Encode(Tag tag, u64 payload) noexcept {
+        Value value;
+        value.raw = (payload << TAG_BITS) | static_cast<u64>(tag);
+        return value;
+    }
+
+    [[nodiscard]] static Value Encode64(Tag tag, u64 immediate,
+                                        std::pmr::memory_resource& memory);
+
+    [[nodiscard]] Tag GetTag() const noexcept {
+        return static_cast<Tag>(raw & TAG_MASK);
+    }
+
+    [[nodiscard]] u64 Payload() const noexcept {
+        return raw >> TAG_BITS;
+    }
+
+    [[nodiscard]] IR::Inst* InstPointer() const noexcept {
+        return reinterpret_cast<IR::Inst*>(raw & ~TAG_MASK);
+    }
+
+    [[nodiscard]] bool IsWideImmediate() const noexcept {
+        return GetTag() == Tag::U64Wide || GetTag() == Tag::F64Wide;
+    }
+
+    /// Decodes a 64-bit immediate regardless of the tag it was stored with
+    [[nodiscard]] u64 Immediate64() const noexcept;
+
+    u64 raw{};
 };
-static_assert(static_cast<u32>(IR::Type::Void) == 0, "memset relies on IR::Type being zero");
+static_assert(sizeof(Value) == sizeof(u64));
 static_assert(std::is_trivially_copyable_v<Value>);
 
 template <IR::Type type_>
@@ -114,9 +185,75 @@ public:
     explicit TypedValue(IR::Inst* inst_) : TypedValue(Value(inst_)) {}
 };
 
-class Inst : public boost::intrusive::list_base_hook<> {
+/**
+ * @brief An IR instruction laid out to fit in a single cache line
+ * @note The arguments of most instructions are stored inline, phi operands and the arguments of
+ * the few instructions taking more than NUM_INLINE_ARGS are stored out-of-line
+ * @note Every instruction keeps a list of its users, replacing an instruction rewrites the
+ * arguments of its users directly rather than forwarding them through an identity
+ * @note An argument holding an instruction points to its own node in the user list of that
+ * instruction, so adding or removing a use is O(1)
+ */
+class alignas(64) Inst : public boost::intrusive::list_base_hook<> {
+private:
+    struct UseNode;
+
 public:
-    explicit Inst(IR::Opcode op_, u32 flags_) noexcept;
+    /**
+     * @brief Iterates the users of an instruction, a user taking the instruction as several
+     * arguments is visited once per argument
+     */
+    class UserIterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Inst*;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Inst* const*;
+        using reference = Inst*;
+
+        UserIterator() noexcept = default;
+        explicit UserIterator(const UseNode* node_) noexcept : node{node_} {}
+
+        [[nodiscard]] Inst* operator*() const noexcept;
+
+        UserIterator& operator++() noexcept;
+
+        UserIterator operator++(int) noexcept {
+            UserIterator copy{*this};
+            ++*this;
+            return copy;
+        }
+
+        [[nodiscard]] bool operator==(std::default_sentinel_t) const noexcept {
+            return node == nullptr;
+        }
+
+        [[nodiscard]] bool operator==(const UserIterator& other) const noexcept {
+            return node == other.node;
+        }
+
+    private:
+        const UseNode* node{};
+    };
+
+    struct UserRange {
+        UserIterator first;
+
+        [[nodiscard]] UserIterator begin() const noexcept {
+            return first;
+        }
+
+        [[nodiscard]] std::default_sentinel_t end() const noexcept {
+            return std::default_sentinel;
+        }
+    };
+
+    /// The largest amount of arguments stored inside the instruction
+    static constexpr size_t NUM_INLINE_ARGS{3};
+
+    /// @param memory_ The resource phi operands, wide arguments and pseudo-operation tables are
+    /// allocated from
+    explicit Inst(IR::Opcode op_, u32 flags_, std::pmr::memory_resource* memory_);
     explicit Inst(const Inst& base);
     ~Inst();
 
@@ -141,8 +278,11 @@ public:
     }
 
     /// Determines if there is a pseudo-operation associated with this instruction.
-    [[nodiscard]] bool HasAssociatedPseudoOperation() const noexcept {
-        return associated_insts != nullptr;
+    [[nodiscard]] bool HasAssociatedPseudoOperation() const noexcept;
+
+    /// The instructions using this instruction as an argument, in no particular order
+    [[nodiscard]] UserRange Users() const noexcept {
+        return UserRange{UserIterator{FirstUse()}};
     }
 
     /// Determines whether or not this instruction may have side effects.
@@ -163,16 +303,15 @@ public:
 
     /// Get the number of arguments this instruction has.
     [[nodiscard]] size_t NumArgs() const {
-        return op == IR::Opcode::Phi ? phi_args.size() : NumArgsOf(op);
+        return op == IR::Opcode::Phi ? phi_args->size() : NumArgsOf(op);
     }
 
     /// Get the value of a given argument index.
     [[nodiscard]] Value Arg(size_t index) const noexcept {
         if (op == IR::Opcode::Phi) {
-            return phi_args[index].second;
-        } else {
-            return args[index];
+            return LoadArg((*phi_args)[index].second);
         }
+        return LoadArg(ArgStorage(op)[index]);
     }
 
     /// Set the value of a given argument index.
@@ -182,6 +321,8 @@ public:
     [[nodiscard]] Block* PhiBlock(size_t index) const;
     /// Add phi operand to a phi instruction.
     void AddPhiOperand(Block* predecessor, const Value& value);
+    /// Remove the phi operand of a predecessor which no longer branches to the phi's block.
+    void RemovePhiOperand(Block* predecessor);
 
     /// Orders the Phi arguments from farthest away to nearest.
     void OrderPhiArgs();
@@ -189,6 +330,11 @@ public:
     void Invalidate();
     void ClearArgs();
 
+    /**
+     * @brief Reroutes every user to the replacement in O(uses) and invalidates the instruction
+     * @note No identity is left behind, callers owning the instruction may erase it right away and
+     * it's otherwise removed by dead code elimination
+     */
     void ReplaceUsesWith(Value replacement);
 
     void ReplaceOpcode(IR::Opcode opcode);
@@ -236,8 +382,84 @@ private:
         NonTriviallyDummy() noexcept {}
     };
 
-    void Use(const Value& value);
-    void UndoUse(const Value& value);
+    using PhiArgs = boost::container::small_vector<
+        std::pair<Block*, Value>, 2, std::pmr::polymorphic_allocator<std::pair<Block*, Value>>>;
+
+    /// The amount of arguments stored out-of-line, every opcode taking more arguments than can be
+    /// stored inline gets the same amount of storage
+    static constexpr size_t NUM_WIDE_ARGS{5};
+
+    /// Set on the head of the user list when it points to a node rather than the memory resource
+    static constexpr uintptr_t IS_USE_BIT{1};
+
+    /// A node of the list of users, every argument holding an instruction has its own node, it's
+    /// allocated from the memory resource of the used instruction and aligned so its address can
+    /// be tagged in the argument slot
+    struct alignas(Value::TAG_ALIGNMENT) UseNode {
+        Inst* user;
+        Value value; ///< The used instruction
+        UseNode* prev;
+        UseNode* next;
+        std::pmr::memory_resource* memory; ///< The memory resource of the used instruction
+    };
+    static_assert(alignof(UseNode) >= (size_t{1} << Value::TAG_BITS),
+                  "Use node pointers can't be tagged");
+
+    /// Decodes the value stored in an argument slot
+    [[nodiscard]] static Value LoadArg(const Value& slot) noexcept {
+        if (slot.GetTag() == Value::Tag::Use) {
+            return UsePointer(slot)->value;
+        }
+        return slot;
+    }
+
+    [[nodiscard]] static Value EncodeUse(const UseNode* node) noexcept {
+        Value value;
+        value.raw = reinterpret_cast<u64>(node) | static_cast<u64>(Value::Tag::Use);
+        return value;
+    }
+
+    [[nodiscard]] static UseNode* UsePointer(const Value& slot) noexcept {
+        return reinterpret_cast<UseNode*>(slot.raw & ~Value::TAG_MASK);
+    }
+
+    [[nodiscard]] UseNode* FirstUse() const noexcept {
+        if ((uses & IS_USE_BIT) == 0) {
+            return nullptr;
+        }
+        return reinterpret_cast<UseNode*>(uses & ~IS_USE_BIT);
+    }
+
+    [[nodiscard]] static bool HasWideArgs(IR::Opcode opcode) noexcept {
+        return opcode != Opcode::Phi && NumArgsOf(opcode) > NUM_INLINE_ARGS;
+    }
+
+    /// The argument storage of a non-phi instruction with the given opcode
+    [[nodiscard]] const Value* ArgStorage(IR::Opcode opcode) const noexcept {
+        return HasWideArgs(opcode) ? wide_args : args.data();
+    }
+    [[nodiscard]] Value* ArgStorage(IR::Opcode opcode) noexcept {
+        return HasWideArgs(opcode) ? wide_args : args.data();
+    }
+
+    /// Constructs the argument storage of a non-phi instruction with the opcode
+    void ConstructArgs(IR::Opcode opcode);
+
+    /// Releases the argument storage of the current opcode, the arguments must have been cleared
+    void DestroyArgs();
+
+    [[nodiscard]] std::pmr::memory_resource* Memory() const noexcept;
+
+    /// Encodes a resolved value for an argument slot, a use is added for instructions
+    [[nodiscard]] Value StoreArg(const Value& value);
+    /// Removes the use of an argument slot, if any, the slot itself is left as is
+    static void ReleaseArg(const Value& slot) noexcept;
+
+    /// Adds a node for the user to the user list, pseudo-operations aren't validated
+    [[nodiscard]] UseNode* AddUser(Inst* user);
+
+    /// Rewrites the argument using a node, which is released, to hold a new value instead
+    void RedirectArg(UseNode* node, const Value& new_value);
 
     IR::Opcode op{};
     int use_count{};
@@ -245,23 +467,25 @@ private:
     u32 definition{};
     union {
         NonTriviallyDummy dummy{};
-        boost::container::small_vector<std::pair<Block*, Value>, 2> phi_args;
-        std::array<Value, 5> args;
+        std::array<Value, NUM_INLINE_ARGS> args;
+        Value* wide_args;
+        PhiArgs* phi_args;
     };
-    std::unique_ptr<AssociatedInsts> associated_insts;
+    /// The first node of the list of users or, while there are no users, the memory resource of
+    /// the instruction which is otherwise found in every node
+    uintptr_t uses;
 };
-static_assert(sizeof(Inst) <= 128, "Inst size unintentionally increased");
+static_assert(sizeof(Inst) <= 64, "Inst size unintentionally increased");
+static_assert(alignof(Inst) >= (size_t{1} << Value::TAG_BITS), "Inst pointers can't be tagged");
 
-struct AssociatedInsts {
-    union {
-        Inst* in_bounds_inst;
-        Inst* sparse_inst;
-        Inst* zero_inst{};
-    };
-    Inst* sign_inst{};
-    Inst* carry_inst{};
-    Inst* overflow_inst{};
-};
+inline Inst* Inst::UserIterator::operator*() const noexcept {
+    return node->user;
+}
+
+inline Inst::UserIterator& Inst::UserIterator::operator++() noexcept {
+    node = node->next;
+    return *this;
+}
 
 using U1 = TypedValue<Type::U1>;
 using U8 = TypedValue<Type::U8>;
@@ -279,137 +503,148 @@ using F16F32F64 = TypedValue<Type::F16 | Type::F32 | Type::F64>;
 using UAny = TypedValue<Type::U8 | Type::U16 | Type::U32 | Type::U64>;
 
 inline bool Value::IsIdentity() const noexcept {
-    return type == Type::Opaque && inst->GetOpcode() == Opcode::Identity;
+    return GetTag() == Tag::Opaque && InstPointer()->GetOpcode() == Opcode::Identity;
 }
 
 inline bool Value::IsPhi() const noexcept {
-    return type == Type::Opaque && inst->GetOpcode() == Opcode::Phi;
+    return GetTag() == Tag::Opaque && InstPointer()->GetOpcode() == Opcode::Phi;
 }
 
 inline bool Value::IsEmpty() const noexcept {
-    return type == Type::Void;
+    return raw == 0;
 }
 
 inline bool Value::IsImmediate() const noexcept {
-    IR::Type current_type{type};
-    const IR::Inst* current_inst{inst};
-    while (current_type == Type::Opaque && current_inst->GetOpcode() == Opcode::Identity) {
-        const Value& arg{current_inst->Arg(0)};
-        current_type = arg.type;
-        current_inst = arg.inst;
-    }
-    return current_type != Type::Opaque;
+    Value current{*this};
+    while (current.GetTag() == Tag::Opaque &&
+           current.InstPointer()->GetOpcode() == Opcode::Identity) {
+        current = current.InstPointer()->Arg(0);
+    }
+    return current.GetTag() != Tag::Opaque;
 }
 
 inline IR::Inst* Value::Inst() const {
-    DEBUG_ASSERT(type == Type::Opaque);
-    return inst;
+    DEBUG_ASSERT(GetTag() == Tag::Opaque);
+    return InstPointer();
 }
 
 inline IR::Inst* Value::InstRecursive() const {
-    DEBUG_ASSERT(type == Type::Opaque);
+    DEBUG_ASSERT(GetTag() == Tag::Opaque);
     if (IsIdentity()) {
-        return inst->Arg(0).InstRecursive();
+        return InstPointer()->Arg(0).InstRecursive();
     }
-    return inst;
+    return InstPointer();
 }
 
 inline IR::Inst* Value::TryInstRecursive() const {
     if (IsIdentity()) {
-        return inst->Arg(0).TryInstRecursive();
+        return InstPointer()->Arg(0).TryInstRecursive();
     }
-    return type == Type::Opaque ? inst : nullptr;
+    return GetTag() == Tag::Opaque ? InstPointer() : nullptr;
 }
 
 inline IR::Value Value::Resolve() const {
     if (IsIdentity()) {
-        return inst->Arg(0).Resolve();
+        return InstPointer()->Arg(0).Resolve();
     }
     return *this;
 }
 
 inline IR::Reg Value::Reg() const {
-    DEBUG_ASSERT(type == Type::Reg);
-    return reg;
+    DEBUG_ASSERT(GetTag() == Tag::Reg);
+    return static_cast<IR::Reg>(Payload());
 }
 
 inline IR::Pred Value::Pred() const {
-    DEBUG_ASSERT(type == Type::Pred);
-    return pred;
+    DEBUG_ASSERT(GetTag() == Tag::Pred);
+    return static_cast<IR::Pred>(Payload());
 }
 
 inline IR::Attribute Value::Attribute() const {
-    DEBUG_ASSERT(type == Type::Attribute);
-    return attribute;
+    DEBUG_ASSERT(GetTag() == Tag::Attribute);
+    return static_cast<IR::Attribute>(Payload());
 }
 
 inline IR::Patch Value::Patch() const {
-    DEBUG_ASSERT(type == Type::Patch);
-    return patch;
+    DEBUG_ASSERT(GetTag() == Tag::Patch);
+    return static_cast<IR::Patch>(Payload());
 }
 
 inline bool Value::U1() const {
     if (IsIdentity()) {
-        return inst->Arg(0).U1();
+        return InstPointer()->Arg(0).U1();
     }
-    DEBUG_ASSERT(type == Type::U1);
-    return imm_u1;
+    DEBUG_ASSERT(GetTag() == Tag::U1);
+    return Payload() != 0;
 }
 
 inline u8 Value::U8() const {
     if (IsIdentity()) {
-        return inst->Arg(0).U8();
+        return InstPointer()->Arg(0).U8();
     }
-    DEBUG_ASSERT(type == Type::U8);
-    return imm_u8;
+    DEBUG_ASSERT(GetTag() == Tag::U8);
+    return static_cast<u8>(Payload());
 }
 
 inline u16 Value::U16() const {
     if (IsIdentity()) {
-        return inst->Arg(0).U16();
+        return InstPointer()->Arg(0).U16();
     }
-    DEBUG_ASSERT(type == Type::U16);
-    return imm_u16;
+    DEBUG_ASSERT(GetTag() == Tag::U16);
+    return static_cast<u16>(Payload());
 }
 
 inline u32 Value::U32() const {
     if (IsIdentity()) {
-        return inst->Arg(0).U32();
+        return InstPointer()->Arg(0).U32();
     }
-    DEBUG_ASSERT(type == Type::U32);
-    return imm_u32;
+    DEBUG_ASSERT(GetTag() == Tag::U32);
+    return static_cast<u32>(Payload());
 }
 
 inline s32 Value::S32() const {
     if (IsIdentity()) {
-        return inst->Arg(0).S32();
+        return InstPointer()->Arg(0).S32();
     }
-    DEBUG_ASSERT(type == Type::S32);
-    return imm_s32;
+    DEBUG_ASSERT(GetTag() == Tag::S32);
+    return static_cast<s32>(static_cast<u32>(Payload()));
 }
 
 inline f32 Value::F32() const {
     if (IsIdentity()) {
-        return inst->Arg(0).F32();
+        return InstPointer()->Arg(0).F32();
     }
-    DEBUG_ASSERT(type == Type::F32);
-    return imm_f32;
+    DEBUG_ASSERT(GetTag() == Tag::F32);
+    return Common::BitCast<f32>(static_cast<u32>(Payload()));
 }
 
 inline u64 Value::U64() const {
     if (IsIdentity()) {
-        return inst->Arg(0).U64();
+        return InstPointer()->Arg(0).U64();
     }
-    DEBUG_ASSERT(type == Type::U64);
-    return imm_u64;
+    DEBUG_ASSERT(GetTag() >= Tag::U64 && GetTag() <= Tag::U64Wide);
+    return Immediate64();
 }
 
 inline f64 Value::F64() const {
     if (IsIdentity()) {
-        return inst->Arg(0).F64();
+        return InstPointer()->Arg(0).F64();
+    }
+    DEBUG_ASSERT(GetTag() >= Tag::F64 && GetTag() <= Tag::F64Wide);
+    return Common::BitCast<f64>(Immediate64());
+}
+
+inline u64 Value::Immediate64() const noexcept {
+    switch (GetTag()) {
+    case Tag::U64Aligned:
+    case Tag::F64Aligned:
+        return raw & ~TAG_MASK;
+    case Tag::U64Wide:
+    case Tag::F64Wide:
+        return reinterpret_cast<const WideImmediate*>(raw & ~TAG_MASK)->value;
+    default:
+        return Payload();
     }
-    DEBUG_ASSERT(type == Type::F64);
-    return imm_f64;
 }
 
 [[nodiscard]] inline bool IsPhi(const Inst& inst) {
@@ -12,26 +12,11 @@
 
 #include <shader_compiler/exception.h>
 #include <shader_compiler/frontend/maxwell/control_flow.h>
-#include <shader_compiler/frontend/maxwell/decode.h>
 #include <shader_compiler/frontend/maxwell/indirect_branch_table_track.h>
 #include <shader_compiler/frontend/maxwell/location.h>
 
 namespace Shader::Maxwell::Flow {
 namespace {
-struct Compare {
-    bool operator()(const Block& lhs, Location rhs) const noexcept {
-        return lhs.begin < rhs;
-    }
-
-    bool operator()(Location lhs, const Block& rhs) const noexcept {
-        return lhs < rhs.begin;
-    }
-
-    bool operator()(const Block& lhs, const Block& rhs) const noexcept {
-        return lhs.begin < rhs.begin;
-    }
-};
-
 u32 BranchOffset(Location pc, Instruction inst) {
     return pc.Offset() + static_cast<u32>(inst.branch.Offset()) + 8u;
 }
@@ -52,10 +37,10 @@ void Split(Block* old_block, Block* new_block, Location pc) {
     new_block->return_block = old_block->return_block;
     new_block->branch_reg = old_block->branch_reg;
     new_block->branch_offset = old_block->branch_offset;
-    new_block->indirect_branches = std::move(old_block->indirect_branches);
+    new_block->indirect_branches = old_block->indirect_branches;
 
     const Location old_begin{old_block->begin};
-    Stack old_stack{std::move(old_block->stack)};
+    const Stack old_stack{old_block->stack};
     *old_block = Block{};
     old_block->begin = old_begin;
     old_block->end = pc;
@@ -134,43 +119,77 @@ std::string NameOf(const Block& block) {
 }
 } // Anonymous namespace
 
-void Stack::Push(Token token, Location target) {
-    entries.push_back({
-        .token = token,
-        .target{target},
+Stack StackTable::Push(Stack stack, Token token, Location target) {
+    nodes.push_back(Node{
+        .entry{
+            .token = token,
+            .target{target},
+        },
+        .below = stack,
     });
+    Stack result;
+    result.top = static_cast<u32>(nodes.size());
+    return result;
 }
 
-std::pair<Location, Stack> Stack::Pop(Token token) const {
-    const std::optional<Location> pc{Peek(token)};
-    if (!pc) {
+std::pair<Location, Stack> StackTable::Pop(Stack stack, Token token) const {
+    const std::optional<u32> index{Find(stack, token)};
+    if (!index) {
         throw LogicError("Token could not be found");
     }
-    return {*pc, Remove(token)};
+    const Node& node{nodes[*index]};
+    return {node.entry.target, node.below};
 }
 
-std::optional<Location> Stack::Peek(Token token) const {
-    const auto it{std::find_if(entries.rbegin(), entries.rend(),
-                               [token](const auto& entry) { return entry.token == token; })};
-    if (it == entries.rend()) {
+std::optional<Location> StackTable::Peek(Stack stack, Token token) const {
+    const std::optional<u32> index{Find(stack, token)};
+    if (!index) {
         return std::nullopt;
     }
-    return it->target;
+    return nodes[*index].entry.target;
 }
 
-Stack Stack::Remove(Token token) const {
-    const auto it{std::find_if(entries.rbegin(), entries.rend(),
-                               [token](const auto& entry) { return entry.token == token; })};
-    const auto pos{std::distance(entries.rbegin(), it)};
-    Stack result;
-    result.entries.insert(result.entries.end(), entries.begin(), entries.end() - pos - 1);
-    return result;
+Stack StackTable::Remove(Stack stack, Token token) const {
+    const std::optional<u32> index{Find(stack, token)};
+    if (!index) {
+        throw LogicError("Token could not be found");
+    }
+    return nodes[*index].below;
+}
+
+std::optional<u32> StackTable::Find(Stack stack, Token token) const {
+    while (!stack.Empty()) {
+        const u32 index{stack.top - 1};
+        if (nodes[index].entry.token == token) {
+            return index;
+        }
+        stack = nodes[index].below;
+    }
+    return std::nullopt;
 }
 
 bool Block::Contains(Location pc) const noexcept {
     return pc >= begin && pc < end;
 }
 
+size_t BlockList::LowerBound(Location pc) const noexcept {
+    const auto it{std::ranges::lower_bound(blocks, pc, {}, &Block::begin)};
+    return static_cast<size_t>(std::distance(blocks.begin(), it));
+}
+
+size_t BlockList::UpperBound(Location pc) const noexcept {
+    const auto it{std::ranges::upper_bound(blocks, pc, {}, &Block::begin)};
+    return static_cast<size_t>(std::distance(blocks.begin(), it));
+}
+
+void BlockList::Insert(Block* block) {
+    const auto it{std::ranges::lower_bound(blocks, block->begin, {}, &Block::begin)};
+    if (it != blocks.end() && (*it)->begin == block->begin) {
+        return;
+    }
+    blocks.insert(it, block);
+}
+
 Function::Function(ObjectPool<Block>& block_pool, Location start_address)
     : entrypoint{start_address} {
     Label& label{labels.emplace_back()};
@@ -186,15 +205,15 @@ Function::Function(ObjectPool<Block>& block_pool, Location start_address)
 
 CFG::CFG(Environment& env_, ObjectPool<Block>& block_pool_, Location start_address,
          bool exits_to_dispatcher_)
-    : env{env_}, block_pool{block_pool_}, program_start{start_address}, exits_to_dispatcher{
-                                                                            exits_to_dispatcher_} {
+    : env{env_}, instructions{env_, start_address},
+      indirect_branch_tracker{instructions, start_address}, block_pool{block_pool_},
+      program_start{start_address}, exits_to_dispatcher{exits_to_dispatcher_} {
     if (exits_to_dispatcher) {
         dispatch_block = block_pool.Create(Block{});
         dispatch_block->begin = {};
         dispatch_block->end = {};
         dispatch_block->end_class = EndClass::Exit;
         dispatch_block->cond = IR::Condition(true);
-        dispatch_block->stack = {};
         dispatch_block->branch_true = nullptr;
         dispatch_block->branch_false = nullptr;
     }
@@ -208,10 +227,11 @@ CFG::CFG(Environment& env_, ObjectPool<Block>& block_pool_, Location start_addre
         }
     }
     if (exits_to_dispatcher) {
-        const auto last_block{functions[0].blocks.rbegin()};
-        dispatch_block->begin = last_block->end + 1;
-        dispatch_block->end = last_block->end + 1;
-        functions[0].blocks.insert(*dispatch_block);
+        BlockList& blocks{functions[0].blocks};
+        const Block& last_block{blocks[blocks.size() - 1]};
+        dispatch_block->begin = last_block.end + 1;
+        dispatch_block->end = last_block.end + 1;
+        blocks.Insert(dispatch_block);
     }
 }
 
@@ -223,9 +243,9 @@ void CFG::AnalyzeLabel(FunctionId function_id, Label& label) {
     // Try to find the next block
     Function* const function{&functions[function_id]};
     Location pc{label.address};
-    const auto next_it{function->blocks.upper_bound(pc, Compare{})};
-    const bool is_last{next_it == function->blocks.end()};
-    Block* const next{is_last ? nullptr : &*next_it};
+    const size_t next_index{function->blocks.UpperBound(pc)};
+    const bool is_last{next_index == function->blocks.size()};
+    Block* const next{is_last ? nullptr : &function->blocks[next_index]};
     // Insert before the next block
     Block* const block{label.block};
     // Analyze instructions until it reaches an already visited block or there's a branch
@@ -247,31 +267,32 @@ void CFG::AnalyzeLabel(FunctionId function_id, Label& label) {
     }
     // Function's pointer might be invalid, resolve it again
     // Insert the new block
-    functions[function_id].blocks.insert(*block);
+    functions[function_id].blocks.Insert(block);
 }
 
 bool CFG::InspectVisitedBlocks(FunctionId function_id, const Label& label) {
     const Location pc{label.address};
     Function& function{functions[function_id]};
-    const auto it{
-        ranges::find_if(function.blocks, [pc](auto& block) { return block.Contains(pc); })};
-    if (it == function.blocks.end()) {
+    // Blocks never overlap, only the last block starting at or before the address can contain it
+    const size_t index{function.blocks.UpperBound(pc)};
+    if (index == 0 || !function.blocks[index - 1].Contains(pc)) {
         // Address has not been visited
         return false;
     }
-    Block* const visited_block{&*it};
+    Block* const visited_block{&function.blocks[index - 1]};
     if (visited_block->begin == pc) {
         throw LogicError("Dangling block");
     }
     Block* const new_block{label.block};
     Split(visited_block, new_block, pc);
-    function.blocks.insert(it, *new_block);
+    function.blocks.Insert(new_block);
     return true;
 }
 
 CFG::AnalysisState CFG::AnalyzeInst(Block* block, FunctionId function_id, Location pc) {
-    const Instruction inst{env.ReadInstruction(pc.Offset())};
-    const Opcode opcode{Decode(inst.raw)};
+    const DecodedInstruction decoded{instructions.Fetch(pc)};
+    const Instruction inst{decoded.raw};
+    const Opcode opcode{decoded.opcode};
     switch (opcode) {
     case Opcode::BRA:
     case Opcode::JMP:
@@ -299,7 +320,7 @@ CFG::AnalysisState CFG::AnalyzeInst(Block* block, FunctionId function_id, Locati
         if (!AnalyzeBranch(block, function_id, pc, inst, opcode)) {
             return AnalysisState::Continue;
         }
-        const auto [stack_pc, new_stack]{block->stack.Pop(OpcodeToken(opcode))};
+        const auto [stack_pc, new_stack]{stacks.Pop(block->stack, OpcodeToken(opcode))};
         block->branch_true = AddLabel(block, new_stack, stack_pc, function_id);
         block->end = pc;
         return AnalysisState::Branch;
@@ -316,7 +337,7 @@ CFG::AnalysisState CFG::AnalyzeInst(Block* block, FunctionId function_id, Locati
     case Opcode::PEXIT:
     case Opcode::PLONGJMP:
     case Opcode::SSY:
-        block->stack.Push(OpcodeToken(opcode), BranchOffset(pc, inst));
+        block->stack = stacks.Push(block->stack, OpcodeToken(opcode), BranchOffset(pc, inst));
         return AnalysisState::Continue;
     case Opcode::BRX:
     case Opcode::JMX:
@@ -378,9 +399,9 @@ void CFG::AnalyzeCondInst(Block* block, FunctionId function_id, Location pc,
     virtual_block.branch_true = conditional_block;
     virtual_block.branch_false = nullptr;
     // Save the contents of the visited block in the conditional block
-    *conditional_block = std::move(*block);
+    *conditional_block = *block;
     // Impersonate the visited block with a virtual block
-    *block = std::move(virtual_block);
+    *block = virtual_block;
     // Set the end properties of the conditional instruction
     conditional_block->end = pc + 1;
     conditional_block->end_class = insn_end_class;
@@ -397,7 +418,7 @@ void CFG::AnalyzeCondInst(Block* block, FunctionId function_id, Location pc,
         conditional_block->branch_false = nullptr;
     }
     // Finally insert the condition block into the list of blocks
-    functions[function_id].blocks.insert(*conditional_block);
+    functions[function_id].blocks.Insert(conditional_block);
 }
 
 bool CFG::AnalyzeBranch(Block* block, FunctionId function_id, Location pc, Instruction inst,
@@ -428,9 +449,8 @@ void CFG::AnalyzeBRA(Block* block, FunctionId function_id, Location pc, Instruct
 
 CFG::AnalysisState CFG::AnalyzeBRX(Block* block, Location pc, Instruction inst, bool is_absolute,
                                    FunctionId function_id) {
-    const std::optional brx_table{TrackIndirectBranchTable(env, pc, program_start)};
+    const std::optional brx_table{indirect_branch_tracker.Track(pc)};
     if (!brx_table) {
-        TrackIndirectBranchTable(env, pc, program_start);
         throw NotImplementedException("Failed to track indirect branch");
     }
     const IR::FlowTest flow_test{inst.branch.flow_test};
@@ -438,28 +458,28 @@ CFG::AnalysisState CFG::AnalyzeBRX(Block* block, Location pc, Instruction inst,
     if (flow_test != IR::FlowTest::T || pred != Predicate{true}) {
         throw NotImplementedException("Conditional indirect branch");
     }
-    std::vector<u32> targets;
-    targets.reserve(brx_table->num_entries);
-    for (u32 i = 0; i < brx_table->num_entries; ++i) {
-        u32 target{env.ReadCbufValue(brx_table->cbuf_index, brx_table->cbuf_offset + i * 4)};
+    std::vector<u32> targets(brx_table->num_entries);
+    env.ReadCbufValues(brx_table->cbuf_index, brx_table->cbuf_offset, targets);
+    for (u32& target : targets) {
         if (!is_absolute) {
             target += pc.Offset();
         }
         target += static_cast<u32>(brx_table->branch_offset);
         target += 8;
-        targets.push_back(target);
     }
     ranges::sort(targets);
     targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
 
-    block->indirect_branches.reserve(targets.size());
+    std::vector<IndirectBranch>& indirect_branches{indirect_branch_tables.emplace_back()};
+    indirect_branches.reserve(targets.size());
     for (const u32 target : targets) {
         Block* const branch{AddLabel(block, block->stack, target, function_id)};
-        block->indirect_branches.push_back({
+        indirect_branches.push_back({
             .block = branch,
             .address = target,
         });
     }
+    block->indirect_branches = indirect_branches;
     block->cond = IR::Condition{true};
     block->end = pc + 1;
     block->end_class = EndClass::IndirectBranch;
@@ -483,7 +503,7 @@ CFG::AnalysisState CFG::AnalyzeEXIT(Block* block, FunctionId function_id, Locati
         throw NotImplementedException("Dispatch EXIT on external function");
     }
     if (pred != Predicate{true} || flow_test != IR::FlowTest::T) {
-        if (block->stack.Peek(Token::PEXIT).has_value()) {
+        if (stacks.Peek(block->stack, Token::PEXIT).has_value()) {
             throw NotImplementedException("Conditional EXIT with PEXIT token");
         }
         const IR::Condition cond{flow_test, static_cast<IR::Pred>(pred.index), pred.negated};
@@ -498,8 +518,8 @@ CFG::AnalysisState CFG::AnalyzeEXIT(Block* block, FunctionId function_id, Locati
         AnalyzeCondInst(block, function_id, pc, EndClass::Exit, cond);
         return AnalysisState::Branch;
     }
-    if (const std::optional<Location> exit_pc{block->stack.Peek(Token::PEXIT)}) {
-        const Stack popped_stack{block->stack.Remove(Token::PEXIT)};
+    if (const std::optional<Location> exit_pc{stacks.Peek(block->stack, Token::PEXIT)}) {
+        const Stack popped_stack{stacks.Remove(block->stack, Token::PEXIT)};
         block->cond = IR::Condition{true};
         block->branch_true = AddLabel(block, popped_stack, *exit_pc, function_id);
         block->branch_false = nullptr;
@@ -524,19 +544,20 @@ Block* CFG::AddLabel(Block* block, Stack stack, Location pc, FunctionId function
         // Jumps to itself
         return block;
     }
-    if (const auto it{function.blocks.find(pc, Compare{})}; it != function.blocks.end()) {
+    const size_t index{function.blocks.LowerBound(pc)};
+    if (index != function.blocks.size() && function.blocks[index].begin == pc) {
         // Block already exists and it has been visited
-        if (function.blocks.begin() != it) {
+        if (index != 0) {
             // Check if the previous node is the virtual variant of the label
             // This won't exist if a virtual node is not needed or it hasn't been visited
             // If it hasn't been visited and a virtual node is needed, this will still behave as
             // expected because the node impersonated with its virtual node.
-            const auto prev{std::prev(it)};
-            if (it->begin.Virtual() == prev->begin) {
-                return &*prev;
+            Block& prev{function.blocks[index - 1]};
+            if (pc.Virtual() == prev.begin) {
+                return &prev;
             }
         }
-        return &*it;
+        return &function.blocks[index];
     }
     // Make sure we don't insert the same layer twice
     const auto label_it{ranges::find(function.labels, pc, &Label::address)};
@@ -554,7 +575,7 @@ Block* CFG::AddLabel(Block* block, Stack stack, Location pc, FunctionId function
     function.labels.push_back(Label{
         .address{pc},
         .block = new_block,
-        .stack{std::move(stack)},
+        .stack = stack,
     });
     return new_block;
 }
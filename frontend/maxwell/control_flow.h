@@ -3,18 +3,21 @@
 
 #pragma once
 
+#include <deque>
 #include <optional>
 #include <span>
 #include <string>
 #include <vector>
 
 #include <boost/container/small_vector.hpp>
-#include <boost/intrusive/set.hpp>
+#include <boost/iterator/indirect_iterator.hpp>
 
 #include <shader_compiler/environment.h>
 #include <shader_compiler/frontend/ir/condition.h>
 #include <shader_compiler/frontend/ir/reg.h>
+#include <shader_compiler/frontend/maxwell/indirect_branch_table_track.h>
 #include <shader_compiler/frontend/maxwell/instruction.h>
+#include <shader_compiler/frontend/maxwell/instruction_table.h>
 #include <shader_compiler/frontend/maxwell/location.h>
 #include <shader_compiler/frontend/maxwell/opcodes.h>
 #include <shader_compiler/object_pool.h>
@@ -50,15 +53,41 @@ struct StackEntry {
     Location target;
 };
 
+/// Handle to an immutable stack of tokens, stacks are created and inspected through a StackTable
 class Stack {
 public:
-    void Push(Token token, Location target);
-    [[nodiscard]] std::pair<Location, Stack> Pop(Token token) const;
-    [[nodiscard]] std::optional<Location> Peek(Token token) const;
-    [[nodiscard]] Stack Remove(Token token) const;
+    [[nodiscard]] bool Empty() const noexcept {
+        return top == 0;
+    }
+
+private:
+    friend class StackTable;
+
+    u32 top{}; //!< One past the index of the top entry in its table, zero for an empty stack
+};
+
+/**
+ * @brief Owns every token stack of a control flow graph as a persistent stack
+ * @note Pushing links a new entry to the entries of the stack below it and popping returns the
+ * stack below the popped entry, labels share their common entries instead of copying them
+ */
+class StackTable {
+public:
+    [[nodiscard]] Stack Push(Stack stack, Token token, Location target);
+    [[nodiscard]] std::pair<Location, Stack> Pop(Stack stack, Token token) const;
+    [[nodiscard]] std::optional<Location> Peek(Stack stack, Token token) const;
+    [[nodiscard]] Stack Remove(Stack stack, Token token) const;
 
 private:
-    std::vector<StackEntry> entries;
+    struct Node {
+        StackEntry entry;
+        Stack below;
+    };
+
+    /// Returns the index of the topmost entry with the token, if any
+    [[nodiscard]] std::optional<u32> Find(Stack stack, Token token) const;
+
+    std::vector<Node> nodes;
 };
 
 struct IndirectBranch {
@@ -66,15 +95,9 @@ struct IndirectBranch {
     u32 address;
 };
 
-struct Block : boost::intrusive::set_base_hook<
-                   // Normal link is ~2.5% faster compared to safe link
-                   boost::intrusive::link_mode<boost::intrusive::normal_link>> {
+struct Block {
     [[nodiscard]] bool Contains(Location pc) const noexcept;
 
-    bool operator<(const Block& rhs) const noexcept {
-        return begin < rhs.begin;
-    }
-
     Location begin;
     Location end;
     EndClass end_class{};
@@ -86,7 +109,49 @@ struct Block : boost::intrusive::set_base_hook<
     Block* return_block{};
     IR::Reg branch_reg{};
     s32 branch_offset{};
-    std::vector<IndirectBranch> indirect_branches;
+    std::span<const IndirectBranch> indirect_branches; //!< Owned by the CFG
+};
+
+/**
+ * @brief The blocks of a function sorted by their starting location
+ * @note Blocks are stored as a flat array of pointers to blocks in the pool, lookups are binary
+ * searches and iterating yields references to the blocks
+ */
+class BlockList {
+public:
+    using const_iterator = boost::indirect_iterator<std::vector<Block*>::const_iterator>;
+
+    [[nodiscard]] const_iterator begin() const noexcept {
+        return const_iterator{blocks.begin()};
+    }
+
+    [[nodiscard]] const_iterator end() const noexcept {
+        return const_iterator{blocks.end()};
+    }
+
+    [[nodiscard]] size_t size() const noexcept {
+        return blocks.size();
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return blocks.empty();
+    }
+
+    [[nodiscard]] Block& operator[](size_t index) const noexcept {
+        return *blocks[index];
+    }
+
+    /// Index of the first block starting at or after the location
+    [[nodiscard]] size_t LowerBound(Location pc) const noexcept;
+
+    /// Index of the first block starting after the location
+    [[nodiscard]] size_t UpperBound(Location pc) const noexcept;
+
+    /// Inserts a block in order, it is ignored if a block already starts at the same location
+    void Insert(Block* block);
+
+private:
+    std::vector<Block*> blocks;
 };
 
 struct Label {
@@ -100,7 +165,7 @@ struct Function {
 
     Location entrypoint;
     boost::container::small_vector<Label, 16> labels;
-    boost::intrusive::set<Block> blocks;
+    BlockList blocks;
 };
 
 class CFG {
@@ -132,6 +197,11 @@ public:
         return exits_to_dispatcher;
     }
 
+    /// The instructions decoded during flow analysis, every block's instructions are present
+    [[nodiscard]] InstructionTable& Instructions() noexcept {
+        return instructions;
+    }
+
 private:
     void AnalyzeLabel(FunctionId function_id, Label& label);
 
@@ -158,6 +228,10 @@ private:
     Block* AddLabel(Block* block, Stack stack, Location pc, FunctionId function_id);
 
     Environment& env;
+    InstructionTable instructions;
+    IndirectBranchTableTracker indirect_branch_tracker;
+    StackTable stacks;
+    std::deque<std::vector<IndirectBranch>> indirect_branch_tables;
     ObjectPool<Block>& block_pool;
     boost::container::small_vector<Function, 1> functions;
     Location program_start;
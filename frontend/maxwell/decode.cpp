@@ -1,11 +1,10 @@
 // SPDX-FileCopyrightText: Copyright 2021 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
-#include <range/v3/algorithm.hpp>
 #include <algorithm>
 #include <array>
 #include <bit>
-#include <memory>
+#include <limits>
 
 #include <shader_compiler/common/common_types.h>
 #include <shader_compiler/exception.h>
@@ -93,56 +92,84 @@ constexpr size_t FastLookupSize() {
 }
 constexpr size_t FAST_LOOKUP_SIZE{FastLookupSize()};
 
-struct InstInfo {
-    [[nodiscard]] u64 Mask() const noexcept {
-        return static_cast<u64>(high_mask) << MASK_SHIFT;
+/// Marks lookup table entries which no encoding matches
+constexpr u16 UNKNOWN_OPCODE{static_cast<u16>(ENCODINGS.size())};
+static_assert(ENCODINGS.size() < std::numeric_limits<u16>::max());
+static_assert(std::has_single_bit(FAST_LOOKUP_SIZE));
+
+/**
+ * @brief Builds a table mapping the leftmost bits of an instruction to its opcode
+ * @note Encodings are sorted from the most to the least specific one, an entry is only claimed by
+ * the first encoding matching it. Only the entries matching an encoding are visited rather than
+ * testing every encoding against every entry, keeping this cheap enough to evaluate at compile time
+ */
+constexpr std::array<u16, FAST_LOOKUP_SIZE> MakeFastLookupTable() {
+    std::array<u16, FAST_LOOKUP_SIZE> table{};
+    table.fill(UNKNOWN_OPCODE);
+    for (const InstEncoding& encoding : ENCODINGS) {
+        const size_t mask{ToFastLookupIndex(encoding.mask_value.mask)};
+        const size_t value{ToFastLookupIndex(encoding.mask_value.value)};
+        const size_t free_bits{~mask & (FAST_LOOKUP_SIZE - 1)};
+        size_t bits{};
+        do {
+            u16& entry{table[value | bits]};
+            if (entry == UNKNOWN_OPCODE) {
+                entry = static_cast<u16>(encoding.opcode);
+            }
+            // Step to the next combination of the bits the encoding doesn't care about
+            bits = (bits - free_bits) & free_bits;
+        } while (bits != 0);
     }
+    return table;
+}
+constexpr auto FAST_LOOKUP_TABLE{MakeFastLookupTable()};
 
-    [[nodiscard]] u64 Value() const noexcept {
-        return static_cast<u64>(high_value) << MASK_SHIFT;
-    }
+static_assert(FAST_LOOKUP_TABLE[ToFastLookupIndex(0xe24000000000000fULL)] ==
+              static_cast<u16>(Opcode::BRA));
 
-    u16 high_mask;
-    u16 high_value;
-    Opcode opcode;
-};
+} // Anonymous namespace
 
-constexpr auto MakeFastLookupTableIndex(size_t index) {
-    std::array<InstInfo, 2> encodings{};
-    size_t element{};
-    for (const auto& encoding : ENCODINGS) {
-        const size_t mask{ToFastLookupIndex(encoding.mask_value.mask)};
-        const size_t value{ToFastLookupIndex(encoding.mask_value.value)};
-        if ((index & mask) == value) {
-            encodings.at(element) = InstInfo{
-                .high_mask = static_cast<u16>(encoding.mask_value.mask >> MASK_SHIFT),
-                .high_value = static_cast<u16>(encoding.mask_value.value >> MASK_SHIFT),
-                .opcode = encoding.opcode,
-            };
-            ++element;
-        }
+Opcode Decode(u64 insn) {
+    const std::optional<Opcode> opcode{TryDecode(insn)};
+    if (!opcode) {
+        throw NotImplementedException("Instruction 0x{:016x} is unknown / unimplemented", insn);
     }
-    return encodings;
+    return *opcode;
 }
 
-/*constexpr*/ auto MakeFastLookupTable() {
-    auto encodings{std::make_unique<std::array<std::array<InstInfo, 2>, FAST_LOOKUP_SIZE>>()};
-    for (size_t index = 0; index < FAST_LOOKUP_SIZE; ++index) {
-        (*encodings)[index] = MakeFastLookupTableIndex(index);
+std::optional<Opcode> TryDecode(u64 insn) noexcept {
+    const u16 opcode{FAST_LOOKUP_TABLE[ToFastLookupIndex(insn)]};
+    if (opcode == UNKNOWN_OPCODE) {
+        return std::nullopt;
     }
-    return encodings;
+    return static_cast<Opcode>(opcode);
 }
-const auto FAST_LOOKUP_TABLE{MakeFastLookupTable()};
-} // Anonymous namespace
 
-Opcode Decode(u64 insn) {
-    const auto& table{(*FAST_LOOKUP_TABLE)[ToFastLookupIndex(insn)]};
-    const auto it{ranges::find_if(
-        table, [insn](const InstInfo& info) { return (insn & info.Mask()) == info.Value(); })};
-    if (it == table.end()) {
-        throw NotImplementedException("Instruction 0x{:016x} is unknown / unimplemented", insn);
+bool DecodeMany(std::span<const u64> insns, std::span<Opcode> opcodes) {
+    if (opcodes.size() < insns.size()) {
+        throw LogicError("Decoding {} instructions into {} opcodes", insns.size(), opcodes.size());
+    }
+    // Unknown instructions are accumulated into a single flag rather than checked one at a time,
+    // this keeps the loop free of branches and lets the compiler vectorize the index computation
+    constexpr size_t BATCH_SIZE{8};
+    bool has_unknown{};
+    size_t index{};
+    for (; index + BATCH_SIZE <= insns.size(); index += BATCH_SIZE) {
+        std::array<u16, BATCH_SIZE> batch;
+        for (size_t lane = 0; lane < BATCH_SIZE; ++lane) {
+            batch[lane] = FAST_LOOKUP_TABLE[ToFastLookupIndex(insns[index + lane])];
+        }
+        for (size_t lane = 0; lane < BATCH_SIZE; ++lane) {
+            has_unknown |= batch[lane] == UNKNOWN_OPCODE;
+            opcodes[index + lane] = static_cast<Opcode>(batch[lane]);
+        }
+    }
+    for (; index < insns.size(); ++index) {
+        const u16 opcode{FAST_LOOKUP_TABLE[ToFastLookupIndex(insns[index])]};
+        has_unknown |= opcode == UNKNOWN_OPCODE;
+        opcodes[index] = static_cast<Opcode>(opcode);
     }
-    return it->opcode;
+    return !has_unknown;
 }
 
 } // namespace Shader::Maxwell
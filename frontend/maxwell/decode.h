@@ -3,11 +3,26 @@
 
 #pragma once
 
+#include <optional>
+#include <span>
+
 #include <shader_compiler/common/common_types.h>
 #include <shader_compiler/frontend/maxwell/opcodes.h>
 
 namespace Shader::Maxwell {
 
+/// Decodes an instruction, throwing NotImplementedException if its encoding is unknown
 [[nodiscard]] Opcode Decode(u64 insn);
 
+/// Decodes an instruction, returning nothing if its encoding is unknown such as for data words
+[[nodiscard]] std::optional<Opcode> TryDecode(u64 insn) noexcept;
+
+/**
+ * @brief Decodes a stream of instructions, this is equivalent to calling TryDecode on every one of
+ * them but avoids a branch per instruction
+ * @return If every instruction is known, the opcodes of unknown instructions are unspecified
+ * @note There must be at least as many opcodes as instructions
+ */
+[[nodiscard]] bool DecodeMany(std::span<const u64> insns, std::span<Opcode> opcodes);
+
 } // namespace Shader::Maxwell
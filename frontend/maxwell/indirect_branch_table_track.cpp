@@ -1,11 +1,12 @@
 // SPDX-FileCopyrightText: Copyright 2021 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <iterator>
 #include <optional>
 
 #include <shader_compiler/common/common_types.h>
 #include <shader_compiler/exception.h>
-#include <shader_compiler/frontend/maxwell/decode.h>
 #include <shader_compiler/frontend/maxwell/indirect_branch_table_track.h>
 #include <shader_compiler/frontend/maxwell/opcodes.h>
 #include <shader_compiler/frontend/maxwell/translate/impl/load_constant.h>
@@ -21,76 +22,55 @@ union Encoding {
     BitField<20, 24, s64> brx_offset;
 };
 
-template <typename Callable>
-std::optional<u64> Track(Environment& env, Location block_begin, Location& pos, Callable&& func) {
-    while (pos >= block_begin) {
-        const u64 insn{env.ReadInstruction(pos.Offset())};
-        --pos;
-        if (func(insn, Decode(insn))) {
-            return insn;
-        }
-    }
-    return std::nullopt;
+bool IsTableLoad(u64 insn, Opcode opcode) {
+    const LDC::Encoding ldc{insn};
+    return opcode == Opcode::LDC && ldc.size == LDC::Size::B32 && ldc.mode == LDC::Mode::Default;
 }
+} // Anonymous namespace
 
-std::optional<u64> TrackLDC(Environment& env, Location block_begin, Location& pos,
-                            IR::Reg brx_reg) {
-    return Track(env, block_begin, pos, [brx_reg](u64 insn, Opcode opcode) {
-        const LDC::Encoding ldc{insn};
-        return opcode == Opcode::LDC && ldc.dest_reg == brx_reg && ldc.size == LDC::Size::B32 &&
-               ldc.mode == LDC::Mode::Default;
-    });
+std::optional<IndirectBranchTableInfo> TrackIndirectBranchTable(InstructionTable& instructions,
+                                                                Location brx_pos,
+                                                                Location block_begin) {
+    IndirectBranchTableTracker tracker{instructions, block_begin};
+    return tracker.Track(brx_pos);
 }
 
-std::optional<u64> TrackSHL(Environment& env, Location block_begin, Location& pos,
-                            IR::Reg ldc_reg) {
-    return Track(env, block_begin, pos, [ldc_reg](u64 insn, Opcode opcode) {
-        const Encoding shl{insn};
-        return opcode == Opcode::SHL_imm && shl.dest_reg == ldc_reg;
-    });
-}
+IndirectBranchTableTracker::IndirectBranchTableTracker(InstructionTable& instructions_,
+                                                       Location block_begin_)
+    : instructions{instructions_}, block_begin{block_begin_}, scan_end{block_begin_} {}
 
-std::optional<u64> TrackIMNMX(Environment& env, Location block_begin, Location& pos,
-                              IR::Reg shl_reg) {
-    return Track(env, block_begin, pos, [shl_reg](u64 insn, Opcode opcode) {
-        const Encoding imnmx{insn};
-        return opcode == Opcode::IMNMX_imm && imnmx.dest_reg == shl_reg;
-    });
-}
-} // Anonymous namespace
-
-std::optional<IndirectBranchTableInfo> TrackIndirectBranchTable(Environment& env, Location brx_pos,
-                                                                Location block_begin) {
-    const u64 brx_insn{env.ReadInstruction(brx_pos.Offset())};
-    const Opcode brx_opcode{Decode(brx_insn)};
+std::optional<IndirectBranchTableInfo> IndirectBranchTableTracker::Track(Location brx_pos) {
+    const DecodedInstruction brx{instructions.Fetch(brx_pos)};
+    const u64 brx_insn{brx.raw};
+    const Opcode brx_opcode{brx.opcode};
     if (brx_opcode != Opcode::BRX && brx_opcode != Opcode::JMX) {
         throw LogicError("Tracked instruction is not BRX or JMX");
     }
     const IR::Reg brx_reg{Encoding{brx_insn}.src_reg};
     const s32 brx_offset{static_cast<s32>(Encoding{brx_insn}.brx_offset)};
 
-    Location pos{brx_pos};
-    const std::optional<u64> ldc_insn{TrackLDC(env, block_begin, pos, brx_reg)};
+    ScanUntil(brx_pos);
+    const std::optional<Candidate> ldc_insn{FindLast(Pattern::LDC, brx_reg, brx_pos)};
     if (!ldc_insn) {
         return std::nullopt;
     }
-    const LDC::Encoding ldc{*ldc_insn};
+    const LDC::Encoding ldc{ldc_insn->insn};
     const u32 cbuf_index{static_cast<u32>(ldc.index)};
     const u32 cbuf_offset{static_cast<u32>(static_cast<s32>(ldc.offset.Value()))};
     const IR::Reg ldc_reg{ldc.src_reg};
 
-    const std::optional<u64> shl_insn{TrackSHL(env, block_begin, pos, ldc_reg)};
+    const std::optional<Candidate> shl_insn{FindLast(Pattern::SHL, ldc_reg, ldc_insn->pos)};
     if (!shl_insn) {
         return std::nullopt;
     }
-    const Encoding shl{*shl_insn};
+    const Encoding shl{shl_insn->insn};
     const IR::Reg shl_reg{shl.src_reg};
 
-    const std::optional<u64> imnmx_insn{TrackIMNMX(env, block_begin, pos, shl_reg)};
+    const std::optional<Candidate> imnmx_insn{FindLast(Pattern::IMNMX, shl_reg, shl_insn->pos)};
     if (!imnmx_insn) {
         return std::nullopt;
     }
-    const Encoding imnmx{*imnmx_insn};
+    const Encoding imnmx{imnmx_insn->insn};
     if (imnmx.is_negative != 0) {
         return std::nullopt;
     }
@@ -104,4 +84,45 @@ std::optional<IndirectBranchTableInfo> TrackIndirectBranchTable(Environment& env
     };
 }
 
+void IndirectBranchTableTracker::ScanUntil(Location pos) {
+    for (; scan_end < pos; ++scan_end) {
+        // Words ahead of the branch may be data embedded in the program, those can't be table
+        // instructions and are skipped rather than failing the whole program
+        const std::optional<DecodedInstruction> insn{instructions.TryFetch(scan_end)};
+        if (!insn) {
+            continue;
+        }
+        const Encoding encoding{insn->raw};
+        std::optional<Pattern> pattern;
+        if (IsTableLoad(insn->raw, insn->opcode)) {
+            pattern = Pattern::LDC;
+        } else if (insn->opcode == Opcode::SHL_imm) {
+            pattern = Pattern::SHL;
+        } else if (insn->opcode == Opcode::IMNMX_imm) {
+            pattern = Pattern::IMNMX;
+        }
+        if (pattern) {
+            // Candidates are indexed in ascending order
+            candidates[Key(*pattern, encoding.dest_reg)].push_back({
+                .pos = scan_end,
+                .insn = insn->raw,
+            });
+        }
+    }
+}
+
+std::optional<IndirectBranchTableTracker::Candidate> IndirectBranchTableTracker::FindLast(
+    Pattern pattern, IR::Reg reg, Location pos) const {
+    const auto it{candidates.find(Key(pattern, reg))};
+    if (it == candidates.end()) {
+        return std::nullopt;
+    }
+    const std::vector<Candidate>& list{it->second};
+    const auto last{std::ranges::lower_bound(list, pos, {}, &Candidate::pos)};
+    if (last == list.begin()) {
+        return std::nullopt;
+    }
+    return *std::prev(last);
+}
+
 } // namespace Shader::Maxwell
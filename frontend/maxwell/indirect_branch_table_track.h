@@ -4,10 +4,12 @@
 #pragma once
 
 #include <optional>
+#include <unordered_map>
+#include <vector>
 
 #include <shader_compiler/common/common_types.h>
-#include <shader_compiler/environment.h>
 #include <shader_compiler/frontend/ir/reg.h>
+#include <shader_compiler/frontend/maxwell/instruction_table.h>
 #include <shader_compiler/frontend/maxwell/location.h>
 
 namespace Shader::Maxwell {
@@ -20,7 +22,52 @@ struct IndirectBranchTableInfo {
     IR::Reg branch_reg{};
 };
 
-std::optional<IndirectBranchTableInfo> TrackIndirectBranchTable(Environment& env, Location brx_pos,
+std::optional<IndirectBranchTableInfo> TrackIndirectBranchTable(InstructionTable& instructions,
+                                                                Location brx_pos,
                                                                 Location block_begin);
 
+/**
+ * @brief Tracks the tables of every indirect branch after a common block begin, the instructions
+ * that can feed a table are indexed by their destination register on the first track so later
+ * branches look them up instead of walking backwards through the program again
+ * @note The results are identical to TrackIndirectBranchTable with the same block begin
+ */
+class IndirectBranchTableTracker {
+public:
+    explicit IndirectBranchTableTracker(InstructionTable& instructions, Location block_begin);
+
+    IndirectBranchTableTracker(const IndirectBranchTableTracker&) = delete;
+    IndirectBranchTableTracker& operator=(const IndirectBranchTableTracker&) = delete;
+
+    [[nodiscard]] std::optional<IndirectBranchTableInfo> Track(Location brx_pos);
+
+private:
+    enum class Pattern : u32 {
+        LDC,
+        SHL,
+        IMNMX,
+    };
+
+    struct Candidate {
+        Location pos;
+        u64 insn;
+    };
+
+    /// Indexes every instruction up to and including the location that wasn't indexed yet
+    void ScanUntil(Location pos);
+
+    /// Finds the last instruction at or before the location matching the pattern and register
+    [[nodiscard]] std::optional<Candidate> FindLast(Pattern pattern, IR::Reg reg,
+                                                    Location pos) const;
+
+    [[nodiscard]] static u32 Key(Pattern pattern, IR::Reg reg) noexcept {
+        return static_cast<u32>(pattern) * static_cast<u32>(IR::NUM_REGS) + static_cast<u32>(reg);
+    }
+
+    InstructionTable& instructions;
+    Location block_begin;
+    Location scan_end;
+    std::unordered_map<u32, std::vector<Candidate>> candidates;
+};
+
 } // namespace Shader::Maxwell
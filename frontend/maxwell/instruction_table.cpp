@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2026 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <algorithm>
+#include <array>
+
+#include <shader_compiler/exception.h>
+#include <shader_compiler/frontend/maxwell/decode.h>
+#include <shader_compiler/frontend/maxwell/instruction_table.h>
+
+namespace Shader::Maxwell {
+
+InstructionTable::InstructionTable(Environment& env, Location program_start)
+    : code{env, program_start.Offset()}, base{program_start.Offset()} {}
+
+DecodedInstruction InstructionTable::Fetch(Location pc) {
+    const Entry entry{Lookup(pc)};
+    if (!entry.is_known) {
+        throw NotImplementedException("Instruction 0x{:016x} is unknown / unimplemented",
+                                      entry.raw);
+    }
+    return DecodedInstruction{.raw = entry.raw, .opcode = entry.opcode};
+}
+
+std::optional<DecodedInstruction> InstructionTable::TryFetch(Location pc) {
+    const Entry entry{Lookup(pc)};
+    if (!entry.is_known) {
+        return std::nullopt;
+    }
+    return DecodedInstruction{.raw = entry.raw, .opcode = entry.opcode};
+}
+
+InstructionTable::Entry InstructionTable::Lookup(Location pc) {
+    if (pc.Offset() < base || pc.IsVirtual()) {
+        const u64 raw{code.Read(pc.Offset())};
+        const std::optional<Opcode> opcode{TryDecode(raw)};
+        return Entry{
+            .raw = raw,
+            .opcode = opcode.value_or(Opcode{}),
+            .is_decoded = true,
+            .is_known = opcode.has_value(),
+        };
+    }
+    const size_t index{(pc.Offset() - base) / sizeof(u64)};
+    if (index < code.View().size()) {
+        if (index >= entries.size() || !entries[index].is_decoded) {
+            DecodeChunk(index);
+        }
+        return entries[index];
+    }
+    if (index >= entries.size()) {
+        entries.resize(std::max(index + 1, entries.size() * 2));
+    }
+    Entry& entry{entries[index]};
+    if (!entry.is_decoded) {
+        entry.raw = code.Read(pc.Offset());
+        const std::optional<Opcode> opcode{TryDecode(entry.raw)};
+        entry.opcode = opcode.value_or(Opcode{});
+        entry.is_known = opcode.has_value();
+        entry.is_decoded = true;
+    }
+    return entry;
+}
+
+void InstructionTable::DecodeChunk(size_t index) {
+    const std::span<const u64> view{code.View()};
+    const size_t begin{index - index % CHUNK_SIZE};
+    const size_t size{std::min(CHUNK_SIZE, view.size() - begin)};
+    const std::span<const u64> words{view.subspan(begin, size)};
+    if (begin + size > entries.size()) {
+        entries.resize(std::max(begin + size, entries.size() * 2));
+    }
+    std::array<Opcode, CHUNK_SIZE> opcodes;
+    const bool is_known{DecodeMany(words, opcodes)};
+    for (size_t offset = 0; offset < size; ++offset) {
+        Entry& entry{entries[begin + offset]};
+        if (entry.is_decoded) {
+            // Decoded entries may be read concurrently, they are never written again
+            continue;
+        }
+        entry.raw = words[offset];
+        entry.opcode = opcodes[offset];
+        // The stream only reports whether any word is unknown, only then is each word checked
+        entry.is_known = is_known || TryDecode(words[offset]).has_value();
+        entry.is_decoded = true;
+    }
+}
+
+} // namespace Shader::Maxwell
@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2026 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include <shader_compiler/common/common_types.h>
+#include <shader_compiler/environment.h>
+#include <shader_compiler/frontend/maxwell/location.h>
+#include <shader_compiler/frontend/maxwell/opcodes.h>
+
+namespace Shader::Maxwell {
+
+/// A raw instruction word alongside its decoded opcode
+struct DecodedInstruction {
+    u64 raw;
+    Opcode opcode;
+};
+
+/**
+ * @brief The instructions of a program decoded at most once, flow analysis fills the table while
+ * walking the program and translation then reuses every entry
+ * @note Entries are indexed by their offset from the start of the program, the code view of the
+ * program is decoded in chunks while locations outside of it are decoded on every fetch
+ */
+class InstructionTable {
+public:
+    explicit InstructionTable(Environment& env, Location program_start);
+
+    InstructionTable(const InstructionTable&) = delete;
+    InstructionTable& operator=(const InstructionTable&) = delete;
+
+    /**
+     * @brief Gets the decoded instruction at the location, decoding it if this is the first fetch
+     * @note Fetching an instruction of the program which was already decoded doesn't modify the
+     * table, such fetches may be made concurrently
+     * @throw NotImplementedException if the encoding of the instruction is unknown
+     */
+    [[nodiscard]] DecodedInstruction Fetch(Location pc);
+
+    /**
+     * @brief Gets the decoded instruction at the location like Fetch, returning nothing if its
+     * encoding is unknown rather than throwing
+     * @note This is used by scans over words which may be data embedded in the program
+     */
+    [[nodiscard]] std::optional<DecodedInstruction> TryFetch(Location pc);
+
+private:
+    /// The amount of words of the code view decoded together
+    static constexpr size_t CHUNK_SIZE{64};
+
+    struct Entry {
+        u64 raw;
+        Opcode opcode;
+        bool is_decoded;
+        bool is_known;
+    };
+
+    [[nodiscard]] Entry Lookup(Location pc);
+
+    /// Decodes every entry of the chunk of the code view containing the index
+    void DecodeChunk(size_t index);
+
+    CodeReader code;
+    std::vector<Entry> entries;
+    u32 base;
+};
+
+} // namespace Shader::Maxwell
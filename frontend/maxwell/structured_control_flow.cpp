@@ -3,7 +3,12 @@
 
 #include <range/v3/algorithm.hpp>
 #include <algorithm>
+#include <exception>
+#include <iterator>
+#include <latch>
 #include <memory>
+#include <memory_resource>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -13,13 +18,14 @@
 
 #include <boost/intrusive/list.hpp>
 
+#include <shader_compiler/batch/thread_pool.h>
+#include <shader_compiler/compile_options.h>
 #include <shader_compiler/environment.h>
 #include <shader_compiler/frontend/ir/basic_block.h>
 #include <shader_compiler/frontend/ir/ir_emitter.h>
 #include <shader_compiler/frontend/maxwell/structured_control_flow.h>
 #include <shader_compiler/frontend/maxwell/translate/translate.h>
 #include <shader_compiler/host_translate_info.h>
-#include <shader_compiler/object_pool.h>
 
 namespace Shader::Maxwell {
 namespace {
@@ -148,6 +154,20 @@ struct Statement : ListBaseHook {
 #pragma warning(pop)
 #endif
 
+/// Statements only link to each other intrusively, they're created in the arena and never destroyed
+class StatementPool {
+public:
+    explicit StatementPool(CompilationArena& arena_) : arena{arena_} {}
+
+    template <typename... Args>
+    [[nodiscard]] Statement* Create(Args&&... args) {
+        return arena.Create<Statement>(std::forward<Args>(args)...);
+    }
+
+private:
+    CompilationArena& arena;
+};
+
 std::string DumpExpr(const Statement* stmt) {
     switch (stmt->type) {
     case StatementType::Identity:
@@ -229,45 +249,6 @@ void SanitizeNoBreaks(const Tree& tree) {
     }
 }
 
-size_t Level(Node stmt) {
-    size_t level{0};
-    Statement* node{stmt->up};
-    while (node) {
-        ++level;
-        node = node->up;
-    }
-    return level;
-}
-
-bool IsDirectlyRelated(Node goto_stmt, Node label_stmt) {
-    const size_t goto_level{Level(goto_stmt)};
-    const size_t label_level{Level(label_stmt)};
-    size_t min_level;
-    size_t max_level;
-    Node min;
-    Node max;
-    if (label_level < goto_level) {
-        min_level = label_level;
-        max_level = goto_level;
-        min = label_stmt;
-        max = goto_stmt;
-    } else { // goto_level < label_level
-        min_level = goto_level;
-        max_level = label_level;
-        min = goto_stmt;
-        max = label_stmt;
-    }
-    while (max_level > min_level) {
-        --max_level;
-        max = max->up;
-    }
-    return min->up == max->up;
-}
-
-bool IsIndirectlyRelated(Node goto_stmt, Node label_stmt) {
-    return goto_stmt->up != label_stmt->up && !IsDirectlyRelated(goto_stmt, label_stmt);
-}
-
 [[maybe_unused]] bool AreSiblings(Node goto_stmt, Node label_stmt) noexcept {
     Node it{goto_stmt};
     do {
@@ -285,34 +266,41 @@ bool IsIndirectlyRelated(Node goto_stmt, Node label_stmt) {
     return false;
 }
 
-Node SiblingFromNephew(Node uncle, Node nephew) noexcept {
-    Statement* const parent{uncle->up};
-    Statement* it{&*nephew};
-    while (it->up != parent) {
-        it = it->up;
-    }
-    return Tree::s_iterator_to(*it);
-}
-
+/**
+ * @brief Checks if a statement comes before another statement with the same parent
+ * @note Both siblings are walked towards the end of the list at the same time, this is
+ * proportional to the distance between them or to the end of the list, whichever is shorter
+ */
 bool AreOrdered(Node left_sibling, Node right_sibling) noexcept {
     const Node end{right_sibling->up->children.end()};
-    for (auto it = right_sibling; it != end; ++it) {
-        if (it == left_sibling) {
+    Node left{left_sibling};
+    Node right{right_sibling};
+    while (true) {
+        if (right == left_sibling || left == end) {
             return false;
         }
+        if (left == right_sibling || right == end) {
+            return true;
+        }
+        ++left;
+        ++right;
     }
-    return true;
 }
 
-bool NeedsLift(Node goto_stmt, Node label_stmt) noexcept {
-    const Node sibling{SiblingFromNephew(goto_stmt, label_stmt)};
-    return AreOrdered(sibling, goto_stmt);
+/// Fills the ancestry with every statement from the root down to the statement, indexed by level
+void BuildAncestry(std::pmr::vector<Statement*>& ancestry, Statement* stmt) {
+    ancestry.clear();
+    for (; stmt; stmt = stmt->up) {
+        ancestry.push_back(stmt);
+    }
+    std::ranges::reverse(ancestry);
 }
 
 class GotoPass {
 public:
-    explicit GotoPass(Flow::CFG& cfg, ObjectPool<Statement>& stmt_pool) : pool{stmt_pool} {
-        std::vector gotos{BuildTree(cfg)};
+    explicit GotoPass(Flow::CFG& cfg, CompilationArena& arena, StatementPool& stmt_pool)
+        : memory{arena.Memory()}, pool{stmt_pool} {
+        std::pmr::vector<Node> gotos{BuildTree(cfg)};
         const auto end{gotos.rend()};
         for (auto goto_stmt = gotos.rbegin(); goto_stmt != end; ++goto_stmt) {
             RemoveGoto(*goto_stmt);
@@ -325,36 +313,52 @@ public:
 
 private:
     void RemoveGoto(Node goto_stmt) {
-        // Force goto_stmt and label_stmt to be directly related
+        // The ancestries are only built once per goto, walking up the tree on every movement
+        // makes deeply nested shaders quadratic. Movements only ever replace the goto with a new
+        // one in its grandparent or in one of its siblings and leave the label's ancestors alone,
+        // except for lifting which wraps the label's ancestor at the goto's level in a loop
         const Node label_stmt{goto_stmt->label};
-        if (IsIndirectlyRelated(goto_stmt, label_stmt)) {
+        BuildAncestry(goto_ancestry, &*goto_stmt);
+        BuildAncestry(label_ancestry, &*label_stmt);
+        size_t goto_level{goto_ancestry.size() - 1};
+        size_t label_level{label_ancestry.size() - 1};
+        const auto move_outward{[&] {
+            goto_stmt = MoveOutward(goto_stmt);
+            goto_ancestry.pop_back();
+            goto_ancestry.back() = &*goto_stmt;
+            --goto_level;
+        }};
+        // Force goto_stmt and label_stmt to be directly related, they are when the ancestors of
+        // both of them at the shallowest of their levels are siblings
+        const auto is_directly_related{[&] {
+            const size_t min_level{std::min(goto_level, label_level)};
+            return goto_ancestry[min_level]->up == label_ancestry[min_level]->up;
+        }};
+        while (!is_directly_related()) {
             // Move goto_stmt out using outward-movement transformation until it becomes
             // directly related to label_stmt
-            while (!IsDirectlyRelated(goto_stmt, label_stmt)) {
-                goto_stmt = MoveOutward(goto_stmt);
-            }
+            move_outward();
         }
         // Force goto_stmt and label_stmt to be siblings
-        if (IsDirectlyRelated(goto_stmt, label_stmt)) {
-            const size_t label_level{Level(label_stmt)};
-            size_t goto_level{Level(goto_stmt)};
-            if (goto_level > label_level) {
-                // Move goto_stmt out of its level using outward-movement transformations
-                while (goto_level > label_level) {
-                    goto_stmt = MoveOutward(goto_stmt);
-                    --goto_level;
-                }
-            } else { // Level(goto_stmt) < Level(label_stmt)
-                if (NeedsLift(goto_stmt, label_stmt)) {
-                    // Lift goto_stmt to above stmt containing label_stmt using goto-lifting
-                    // transformations
-                    goto_stmt = Lift(goto_stmt);
-                }
-                // Move goto_stmt into label_stmt's level using inward-movement transformation
-                while (goto_level < label_level) {
-                    goto_stmt = MoveInward(goto_stmt);
-                    ++goto_level;
-                }
+        if (goto_level > label_level) {
+            // Move goto_stmt out of its level using outward-movement transformations
+            while (goto_level > label_level) {
+                move_outward();
+            }
+        } else { // goto_level <= label_level
+            if (AreOrdered(Tree::s_iterator_to(*label_ancestry[goto_level]), goto_stmt)) {
+                // Lift goto_stmt to above stmt containing label_stmt using goto-lifting
+                // transformations
+                goto_stmt = Lift(goto_stmt, Tree::s_iterator_to(*label_ancestry[goto_level]));
+                label_ancestry.insert(label_ancestry.begin() + goto_level, goto_stmt->up);
+                ++goto_level;
+                ++label_level;
+            }
+            // Move goto_stmt into label_stmt's level using inward-movement transformation
+            while (goto_level < label_level) {
+                goto_stmt =
+                    MoveInward(goto_stmt, Tree::s_iterator_to(*label_ancestry[goto_level]));
+                ++goto_level;
             }
         }
         // Expensive operation:
@@ -374,20 +378,20 @@ private:
         }
     }
 
-    std::vector<Node> BuildTree(Flow::CFG& cfg) {
+    std::pmr::vector<Node> BuildTree(Flow::CFG& cfg) {
         u32 label_id{0};
-        std::vector<Node> gotos;
+        std::pmr::vector<Node> gotos{&memory};
         Flow::Function& first_function{cfg.Functions().front()};
         BuildTree(cfg, first_function, label_id, gotos, root_stmt.children.end(), std::nullopt);
         return gotos;
     }
 
     void BuildTree(Flow::CFG& cfg, Flow::Function& function, u32& label_id,
-                   std::vector<Node>& gotos, Node function_insert_point,
+                   std::pmr::vector<Node>& gotos, Node function_insert_point,
                    std::optional<Node> return_label) {
         Statement* const false_stmt{pool.Create(Identity{}, IR::Condition{false}, &root_stmt)};
         Tree& root{root_stmt.children};
-        std::unordered_map<Flow::Block*, Node> local_labels;
+        std::pmr::unordered_map<Flow::Block*, Node> local_labels{&memory};
         local_labels.reserve(function.blocks.size());
 
         for (Flow::Block& block : function.blocks) {
@@ -505,11 +509,11 @@ private:
         }
     }
 
-    [[nodiscard]] Node MoveInward(Node goto_stmt) {
+    /// Moves the goto into the sibling containing its label
+    [[nodiscard]] Node MoveInward(Node goto_stmt, Node label_nested_stmt) {
         Statement* const parent{goto_stmt->up};
         Tree& body{parent->children};
         const Node label{goto_stmt->label};
-        const Node label_nested_stmt{SiblingFromNephew(goto_stmt, label)};
         const u32 label_id{label->id};
 
         Statement* const goto_cond{goto_stmt->cond};
@@ -543,12 +547,12 @@ private:
         return nested_tree.insert(nested_tree.begin(), *new_goto);
     }
 
-    [[nodiscard]] Node Lift(Node goto_stmt) {
+    /// Lifts the goto above the preceding sibling containing its label, wrapping both in a loop
+    [[nodiscard]] Node Lift(Node goto_stmt, Node label_nested_stmt) {
         Statement* const parent{goto_stmt->up};
         Tree& body{parent->children};
         const Node label{goto_stmt->label};
         const u32 label_id{label->id};
-        const Node label_nested_stmt{SiblingFromNephew(goto_stmt, label)};
 
         Tree loop_body;
         loop_body.splice(loop_body.begin(), body, label_nested_stmt, goto_stmt);
@@ -613,21 +617,22 @@ private:
         return parent_tree.insert(std::next(loop), *new_goto);
     }
 
-    ObjectPool<Statement>& pool;
+    std::pmr::memory_resource& memory;
+    StatementPool& pool;
     Statement root_stmt{FunctionTag{}};
+    std::pmr::vector<Statement*> goto_ancestry{&memory};
+    std::pmr::vector<Statement*> label_ancestry{&memory};
 };
 
-[[nodiscard]] Statement* TryFindForwardBlock(Statement& stmt) {
-    Tree& tree{stmt.up->children};
-    const Node end{tree.end()};
+/// Finds the first statement after the given one which is either code or has children
+[[nodiscard]] Node FindForwardBoundary(Statement& stmt) {
+    const Node end{stmt.up->children.end()};
     Node forward_node{std::next(Tree::s_iterator_to(stmt))};
-    while (forward_node != end && !HasChildren(forward_node->type)) {
-        if (forward_node->type == StatementType::Code) {
-            return &*forward_node;
-        }
+    while (forward_node != end && forward_node->type != StatementType::Code &&
+           !HasChildren(forward_node->type)) {
         ++forward_node;
     }
-    return nullptr;
+    return forward_node;
 }
 
 [[nodiscard]] IR::U1 VisitExpr(IR::IREmitter& ir, const Statement& stmt) {
@@ -649,12 +654,16 @@ private:
 
 class TranslatePass {
 public:
-    TranslatePass(ObjectPool<IR::Inst>& inst_pool_, ObjectPool<IR::Block>& block_pool_,
-                  ObjectPool<Statement>& stmt_pool_, Environment& env_, Statement& root_stmt,
-                  IR::AbstractSyntaxList& syntax_list_, const HostTranslateInfo& host_info)
-        : stmt_pool{stmt_pool_}, inst_pool{inst_pool_}, block_pool{block_pool_}, env{env_},
-          syntax_list{syntax_list_} {
+    TranslatePass(CompilationArena& arena_, StatementPool& stmt_pool_, Environment& env_,
+                  InstructionTable& instructions_, Statement& root_stmt,
+                  IR::AbstractSyntaxList& syntax_list_, const HostTranslateInfo& host_info,
+                  WorkStealingThreadPool* translation_pool_)
+        : stmt_pool{stmt_pool_}, arena{arena_}, env{env_}, instructions{instructions_},
+          syntax_list{syntax_list_}, translation_pool{translation_pool_} {
         Visit(root_stmt, nullptr, nullptr);
+        if (translation_pool) {
+            TranslateConcurrently();
+        }
 
         IR::Block& first_block{*syntax_list.front().data.block};
         IR::IREmitter ir(first_block, first_block.begin());
@@ -671,13 +680,19 @@ private:
             if (current_block) {
                 return;
             }
-            current_block = block_pool.Create(inst_pool);
+            current_block = arena.BlockPool().Create(arena);
             auto& node{syntax_list.emplace_back()};
             node.type = IR::AbstractSyntaxNode::Type::Block;
             node.data.block = current_block;
         }};
         Tree& tree{parent.children};
+        // Every statement before the boundary shares it, it's only searched for again once it
+        // has been visited so long runs of breaks don't rescan the statements following them
+        std::optional<Node> forward_boundary;
         for (auto it = tree.begin(); it != tree.end(); ++it) {
+            if (forward_boundary && it == *forward_boundary) {
+                forward_boundary.reset();
+            }
             Statement& stmt{*it};
             switch (stmt.type) {
             case StatementType::Label:
@@ -685,7 +700,19 @@ private:
                 break;
             case StatementType::Code: {
                 ensure_block();
-                Translate(env, current_block, stmt.block->begin.Offset(), stmt.block->end.Offset());
+                if (!translation_pool) {
+                    Translate(env, instructions, current_block, stmt.block->begin.Offset(),
+                              stmt.block->end.Offset());
+                } else if (stmt.block->begin != stmt.block->end) {
+                    // Deferred until every block is known, the code is inserted after the
+                    // instructions currently in the block
+                    translation_jobs.push_back({
+                        .block = current_block,
+                        .anchor = current_block->empty() ? nullptr : &current_block->back(),
+                        .begin = stmt.block->begin.Offset(),
+                        .end = stmt.block->end.Offset(),
+                    });
+                }
                 break;
             }
             case StatementType::SetVariable: {
@@ -703,7 +730,7 @@ private:
             }
             case StatementType::If: {
                 ensure_block();
-                IR::Block* const merge_block{MergeBlock(parent, stmt)};
+                IR::Block* const merge_block{MergeBlock(parent, stmt, forward_boundary)};
 
                 // Implement if header block
                 IR::IREmitter ir{*current_block};
@@ -737,7 +764,7 @@ private:
                 break;
             }
             case StatementType::Loop: {
-                IR::Block* const loop_header_block{block_pool.Create(inst_pool)};
+                IR::Block* const loop_header_block{arena.BlockPool().Create(arena)};
                 if (current_block) {
                     current_block->AddBranch(loop_header_block);
                 }
@@ -745,8 +772,8 @@ private:
                 header_node.type = IR::AbstractSyntaxNode::Type::Block;
                 header_node.data.block = loop_header_block;
 
-                IR::Block* const continue_block{block_pool.Create(inst_pool)};
-                IR::Block* const merge_block{MergeBlock(parent, stmt)};
+                IR::Block* const continue_block{arena.BlockPool().Create(arena)};
+                IR::Block* const merge_block{MergeBlock(parent, stmt, forward_boundary)};
 
                 const size_t loop_node_index{syntax_list.size()};
                 syntax_list.emplace_back();
@@ -790,7 +817,7 @@ private:
             }
             case StatementType::Break: {
                 ensure_block();
-                IR::Block* const skip_block{MergeBlock(parent, stmt)};
+                IR::Block* const skip_block{MergeBlock(parent, stmt, forward_boundary)};
 
                 IR::IREmitter ir{*current_block};
                 const IR::U1 cond{ir.ConditionRef(VisitExpr(ir, *stmt.cond))};
@@ -811,7 +838,7 @@ private:
             }
             case StatementType::Return: {
                 ensure_block();
-                IR::Block* return_block{block_pool.Create(inst_pool)};
+                IR::Block* return_block{arena.BlockPool().Create(arena)};
                 IR::IREmitter{*return_block}.Epilogue();
                 current_block->AddBranch(return_block);
 
@@ -825,7 +852,7 @@ private:
             }
             case StatementType::Kill: {
                 ensure_block();
-                IR::Block* demote_block{MergeBlock(parent, stmt)};
+                IR::Block* demote_block{MergeBlock(parent, stmt, forward_boundary)};
                 IR::IREmitter{*current_block}.DemoteToHelperInvocation();
                 current_block->AddBranch(demote_block);
                 current_block = demote_block;
@@ -855,14 +882,95 @@ private:
         }
     }
 
-    IR::Block* MergeBlock(Statement& parent, Statement& stmt) {
-        Statement* merge_stmt{TryFindForwardBlock(stmt)};
-        if (!merge_stmt) {
+    IR::Block* MergeBlock(Statement& parent, Statement& stmt,
+                          std::optional<Node>& forward_boundary) {
+        if (!forward_boundary) {
+            forward_boundary = FindForwardBoundary(stmt);
+        }
+        if (*forward_boundary == parent.children.end() ||
+            (*forward_boundary)->type != StatementType::Code) {
             // Create a merge block we can visit later
-            merge_stmt = stmt_pool.Create(&dummy_flow_block, &parent);
+            Statement* const merge_stmt{stmt_pool.Create(&dummy_flow_block, &parent)};
             parent.children.insert(std::next(Tree::s_iterator_to(stmt)), *merge_stmt);
         }
-        return block_pool.Create(inst_pool);
+        return arena.BlockPool().Create(arena);
+    }
+
+    /**
+     * @brief Translates the deferred code of every block on the pool, each worker creates the
+     * instructions of a contiguous run of blocks from its own arena shard and the results are
+     * spliced back into their blocks in program order
+     * @note Flow analysis has decoded every instruction of every block, fetching them again only
+     * reads the instruction table
+     */
+    void TranslateConcurrently() {
+        if (translation_jobs.empty()) {
+            return;
+        }
+        WorkStealingThreadPool& pool{*translation_pool};
+        arena.ReserveShards(pool.NumWorkers());
+
+        size_t total_size{};
+        for (const TranslationJob& job : translation_jobs) {
+            total_size += job.end - job.begin;
+        }
+        // Split the jobs into runs of a similar amount of code, a few per worker so idle workers
+        // can steal the remaining runs of slower ones
+        constexpr size_t RUNS_PER_WORKER{4};
+        const size_t num_runs{
+            std::min(translation_jobs.size(), pool.NumWorkers() * RUNS_PER_WORKER)};
+        const size_t run_size{(total_size + num_runs - 1) / num_runs};
+        std::vector<std::pair<size_t, size_t>> runs;
+        size_t run_begin{};
+        size_t accumulated_size{};
+        for (size_t index = 0; index < translation_jobs.size(); ++index) {
+            const TranslationJob& job{translation_jobs[index]};
+            accumulated_size += job.end - job.begin;
+            if (accumulated_size >= run_size || index + 1 == translation_jobs.size()) {
+                runs.emplace_back(run_begin, index + 1);
+                run_begin = index + 1;
+                accumulated_size = 0;
+            }
+        }
+        std::vector<IR::Block::InstructionList> results(translation_jobs.size());
+        std::vector<std::exception_ptr> exceptions(translation_jobs.size());
+        std::latch done{static_cast<std::ptrdiff_t>(runs.size())};
+        std::vector<WorkStealingThreadPool::Task> tasks;
+        tasks.reserve(runs.size());
+        for (const auto& [first, last] : runs) {
+            tasks.emplace_back([&, first, last](size_t worker_index) {
+                ArenaShard& shard{arena.Shard(worker_index)};
+                IR::Block staging_block{shard.inst_pool, shard.memory};
+                for (size_t index = first; index < last; ++index) {
+                    const TranslationJob& job{translation_jobs[index]};
+                    try {
+                        Translate(env, instructions, &staging_block, job.begin, job.end);
+                    } catch (...) {
+                        exceptions[index] = std::current_exception();
+                    }
+                    results[index].splice(results[index].end(), staging_block.Instructions());
+                }
+                done.count_down();
+            });
+        }
+        pool.Submit(std::move(tasks));
+        done.wait();
+
+        for (const std::exception_ptr& exception : exceptions) {
+            if (exception) {
+                // Report the same error as a sequential translation would
+                std::rethrow_exception(exception);
+            }
+        }
+        // Later jobs are spliced first so that jobs sharing an anchor keep their order
+        for (size_t index = translation_jobs.size(); index-- > 0;) {
+            const TranslationJob& job{translation_jobs[index]};
+            IR::Block::InstructionList& insts{job.block->Instructions()};
+            const auto position{job.anchor ? std::next(insts.iterator_to(*job.anchor))
+                                           : insts.begin()};
+            insts.splice(position, results[index]);
+        }
+        translation_jobs.clear();
     }
 
     void DemoteCombinationPass() {
@@ -970,24 +1078,46 @@ private:
         asl.insert(next_it_2, demote_if_node);
     }
 
-    ObjectPool<Statement>& stmt_pool;
-    ObjectPool<IR::Inst>& inst_pool;
-    ObjectPool<IR::Block>& block_pool;
+    StatementPool& stmt_pool;
+    CompilationArena& arena;
     Environment& env;
+    InstructionTable& instructions;
     IR::AbstractSyntaxList& syntax_list;
+    WorkStealingThreadPool* translation_pool;
     bool uses_demote_to_helper{};
     const Flow::Block dummy_flow_block;
+
+    struct TranslationJob {
+        IR::Block* block;
+        IR::Inst* anchor; ///< The last instruction of the block before the code, null if none
+        u32 begin;
+        u32 end;
+    };
+    std::vector<TranslationJob> translation_jobs;
 };
 } // Anonymous namespace
 
-IR::AbstractSyntaxList BuildASL(ObjectPool<IR::Inst>& inst_pool, ObjectPool<IR::Block>& block_pool,
-                                Environment& env, Flow::CFG& cfg,
-                                const HostTranslateInfo& host_info) {
-    ObjectPool<Statement> stmt_pool{64};
-    GotoPass goto_pass{cfg, stmt_pool};
+IR::AbstractSyntaxList BuildASL(CompilationArena& arena, Environment& env, Flow::CFG& cfg,
+                                const HostTranslateInfo& host_info,
+                                const CompileOptions& options) {
+    WorkStealingThreadPool* translation_pool{};
+    if (options.translation_pool) {
+        size_t num_insts{};
+        for (const Flow::Function& function : cfg.Functions()) {
+            for (const Flow::Block& block : function.blocks) {
+                num_insts += (block.end.Offset() - block.begin.Offset()) / sizeof(u64);
+            }
+        }
+        if (num_insts >= options.parallel_translation_threshold) {
+            translation_pool = options.translation_pool;
+        }
+    }
+    StatementPool stmt_pool{arena};
+    GotoPass goto_pass{cfg, arena, stmt_pool};
     Statement& root{goto_pass.RootStatement()};
     IR::AbstractSyntaxList syntax_list;
-    TranslatePass{inst_pool, block_pool, stmt_pool, env, root, syntax_list, host_info};
+    TranslatePass{arena, stmt_pool, env, cfg.Instructions(), root, syntax_list, host_info,
+                  translation_pool};
     return syntax_list;
 }
 
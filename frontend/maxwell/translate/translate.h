@@ -5,9 +5,12 @@
 
 #include <shader_compiler/environment.h>
 #include <shader_compiler/frontend/ir/basic_block.h>
+#include <shader_compiler/frontend/maxwell/instruction_table.h>
 
 namespace Shader::Maxwell {
 
-void Translate(Environment& env, IR::Block* block, u32 location_begin, u32 location_end);
+/// Translates the instructions in [location_begin, location_end) to IR appended to the block
+void Translate(Environment& env, InstructionTable& instructions, IR::Block* block,
+               u32 location_begin, u32 location_end);
 
 } // namespace Shader::Maxwell
@@ -3,11 +3,12 @@
 
 #include <range/v3/algorithm.hpp>
 #include <algorithm>
+#include <array>
 #include <memory>
+#include <string_view>
 #include <vector>
 #include <queue>
 
-#include <shader_compiler/common/settings.h>
 #include <shader_compiler/exception.h>
 #include <shader_compiler/frontend/ir/basic_block.h>
 #include <shader_compiler/frontend/ir/ir_emitter.h>
@@ -16,6 +17,9 @@
 #include <shader_compiler/frontend/maxwell/translate/translate.h>
 #include <shader_compiler/frontend/maxwell/translate_program.h>
 #include <shader_compiler/host_translate_info.h>
+#include <shader_compiler/instrumentation.h>
+#include <shader_compiler/ir_opt/fused_walk.h>
+#include <shader_compiler/ir_opt/pass_manager.h>
 #include <shader_compiler/ir_opt/passes.h>
 
 namespace Shader::Maxwell {
@@ -173,6 +177,25 @@ std::map<IR::Attribute, IR::Attribute> GenerateLegacyToGenericMappings(
     return mapping;
 }
 
+/// Replaces the legacy attributes accessed by instructions with the generics they're mapped to
+class LegacyAttributeVisitor final : public Optimization::InstructionVisitor {
+public:
+    LegacyAttributeVisitor(VaryingState& state_, std::map<IR::Attribute, IR::Attribute>& mapping_)
+        : state{state_}, mapping{mapping_} {}
+
+    void Visit(IR::Block&, IR::Inst& inst) override {
+        const auto attr = inst.Arg(0).Attribute();
+        if (IsLegacyAttribute(attr)) {
+            state.Set(mapping[attr], true);
+            inst.SetArg(0, Shader::IR::Value(mapping[attr]));
+        }
+    }
+
+private:
+    VaryingState& state;
+    std::map<IR::Attribute, IR::Attribute>& mapping;
+};
+
 void EmitGeometryPassthrough(IR::IREmitter& ir, const IR::Program& program,
                              const Shader::VaryingState& passthrough_mask,
                              bool passthrough_position,
@@ -236,12 +259,149 @@ void LowerGeometryPassthrough(const IR::Program& program, const HostTranslateInf
     }
 }
 
+using Optimization::OpcodeCategory;
+using Optimization::PassContext;
+using Optimization::PassDescriptor;
+
+// Passes requiring an opcode category only rewrite instructions of that category, the pass manager
+// skips them on programs which contain none. Passes removing the instructions of a category which
+// a later pass is gated on invalidate the census, attribute stores are never removed so resource
+// lowering and dead code elimination leave the census taken before them valid
+constexpr std::array TRANSLATION_PIPELINE{
+    PassDescriptor{
+        .name = "RemoveUnreachableBlocks",
+        .run = [](PassContext&, IR::Program& program) { RemoveUnreachableBlocks(program); },
+        .invalidates = Optimization::Analysis::ControlFlow,
+    },
+    // Replace instructions before the SSA rewrite
+    PassDescriptor{
+        .name = "LowerFp16ToFp32",
+        .run = [](PassContext&, IR::Program& program) { Optimization::LowerFp16ToFp32(program); },
+        .enabled = [](const PassContext& ctx) { return !ctx.host_info.support_float16; },
+        .required_categories = OpcodeCategory::Fp16,
+        .invalidates = Optimization::Analysis::OpcodeCensus,
+    },
+    PassDescriptor{
+        .name = "LowerInt64ToInt32",
+        .run = [](PassContext&, IR::Program& program) { Optimization::LowerInt64ToInt32(program); },
+        .enabled = [](const PassContext& ctx) { return !ctx.host_info.support_int64; },
+        .required_categories = OpcodeCategory::Int64,
+        .invalidates = Optimization::Analysis::OpcodeCensus,
+    },
+    PassDescriptor{
+        .name = "SsaRewritePass",
+        .run = [](PassContext&, IR::Program& program) { Optimization::SsaRewritePass(program); },
+    },
+    PassDescriptor{
+        .name = "ConstantPropagationPass",
+        .run =
+            [](PassContext& ctx, IR::Program& program) {
+                Optimization::ConstantPropagationPass(ctx.env, program, ctx.options);
+            },
+        .prerequisites = {"SsaRewritePass"},
+    },
+    // Splices out the code behind branches whose condition became constant before it's walked by
+    // the remaining passes
+    PassDescriptor{
+        .name = "ConstantBranchFoldingPass",
+        .run =
+            [](PassContext&, IR::Program& program) {
+                Optimization::ConstantBranchFoldingPass(program);
+            },
+        .prerequisites = {"ConstantPropagationPass"},
+        .invalidates = Optimization::Analysis::OpcodeCensus | Optimization::Analysis::ControlFlow,
+    },
+    PassDescriptor{
+        .name = "LoopInvariantCodeMotionPass",
+        .run =
+            [](PassContext&, IR::Program& program) {
+                Optimization::LoopInvariantCodeMotionPass(program);
+            },
+        .prerequisites = {"ConstantPropagationPass"},
+    },
+    // Shares values computed more than once before the passes walking and rewriting them, this
+    // includes invariants of sibling blocks which have been hoisted next to each other
+    PassDescriptor{
+        .name = "GlobalValueNumberingPass",
+        .run =
+            [](PassContext&, IR::Program& program) {
+                Optimization::GlobalValueNumberingPass(program);
+            },
+        .prerequisites = {"ConstantPropagationPass"},
+    },
+    // The instructions patched by these passes are collected in a single walk, the passes then
+    // rewrite them in order. Passes without any instruction to patch aren't registered, when
+    // none is left the walk is skipped entirely
+    PassDescriptor{
+        .name = "ResourceLoweringPasses",
+        .run =
+            [](PassContext& ctx, IR::Program& program) {
+                const OpcodeCategory census{Optimization::Census(ctx, program)};
+                Optimization::FusedWalk walk;
+                Optimization::RegisterPositionPass(walk, ctx.env, program);
+                if (True(census & OpcodeCategory::GlobalMemory)) {
+                    Optimization::RegisterGlobalMemoryToStorageBufferPass(walk, program,
+                                                                          ctx.host_info);
+                }
+                if (True(census & OpcodeCategory::Texture)) {
+                    Optimization::RegisterTexturePass(walk, ctx.env, program, ctx.host_info);
+                }
+                if (ctx.options.resolution_info.active) {
+                    Optimization::RegisterRescalingPass(walk, program, ctx.options.resolution_info);
+                }
+                walk.Run(program);
+            },
+        .prerequisites = {"ConstantPropagationPass"},
+    },
+    PassDescriptor{
+        .name = "DeadCodeEliminationPass",
+        .run =
+            [](PassContext&, IR::Program& program) {
+                Optimization::DeadCodeEliminationPass(program);
+            },
+    },
+    // Drops the branches left around nothing once dead code is gone
+    PassDescriptor{
+        .name = "SimplifyControlFlowPass",
+        .run =
+            [](PassContext&, IR::Program& program) {
+                Optimization::SimplifyControlFlowPass(program);
+            },
+        .prerequisites = {"DeadCodeEliminationPass"},
+        .invalidates = Optimization::Analysis::ControlFlow,
+    },
+    PassDescriptor{
+        .name = "VerificationPass",
+        .run = [](PassContext&, IR::Program& program) { Optimization::VerificationPass(program); },
+        .enabled = [](const PassContext& ctx) { return ctx.options.renderer_debug; },
+    },
+    // Layer emulation moves the layer to a generic the program doesn't store to, it shares the
+    // walk collecting the stores
+    PassDescriptor{
+        .name = "CollectShaderInfoPass",
+        .run =
+            [](PassContext& ctx, IR::Program& program) {
+                Optimization::FusedWalk walk;
+                Optimization::RegisterCollectShaderInfoPass(walk, ctx.env, program);
+                if (True(Optimization::Census(ctx, program) & OpcodeCategory::SetAttribute)) {
+                    Optimization::RegisterLayerPass(walk, program, ctx.host_info);
+                }
+                walk.Run(program);
+            },
+        .prerequisites = {"ResourceLoweringPasses"},
+    },
+};
+static_assert(Optimization::IsValidPipeline(TRANSLATION_PIPELINE));
+
 } // Anonymous namespace
 
-IR::Program TranslateProgram(ObjectPool<IR::Inst>& inst_pool, ObjectPool<IR::Block>& block_pool,
-                             Environment& env, Flow::CFG& cfg, const HostTranslateInfo& host_info) {
+IR::Program TranslateProgram(CompilationArena& arena, Environment& env, Flow::CFG& cfg,
+                             const HostTranslateInfo& host_info, const CompileOptions& options) {
     IR::Program program;
-    program.syntax_list = BuildASL(inst_pool, block_pool, env, cfg, host_info);
+    {
+        const PassScope scope{options.instrumentation, "BuildASL", nullptr, &arena.InstPool()};
+        program.syntax_list = BuildASL(arena, env, cfg, host_info, options);
+    }
     program.blocks = GenerateBlocks(program.syntax_list);
     program.post_order_blocks = PostOrder(program.syntax_list.front());
     program.stage = env.ShaderStage();
@@ -278,33 +438,13 @@ IR::Program TranslateProgram(ObjectPool<IR::Inst>& inst_pool, ObjectPool<IR::Blo
     default:
         break;
     }
-    RemoveUnreachableBlocks(program);
-
-    // Replace instructions before the SSA rewrite
-    if (!host_info.support_float16) {
-        Optimization::LowerFp16ToFp32(program);
-    }
-    if (!host_info.support_int64) {
-        Optimization::LowerInt64ToInt32(program);
-    }
-    Optimization::SsaRewritePass(program);
-
-    Optimization::ConstantPropagationPass(env, program);
-
-    Optimization::PositionPass(env, program);
-
-    Optimization::GlobalMemoryToStorageBufferPass(program, host_info);
-    Optimization::TexturePass(env, program, host_info);
-
-    if (Settings::values.resolution_info.active) {
-        Optimization::RescalingPass(program);
-    }
-    Optimization::DeadCodeEliminationPass(program);
-    if (Settings::values.renderer_debug) {
-        Optimization::VerificationPass(program);
-    }
-    Optimization::CollectShaderInfoPass(env, program);
-    Optimization::LayerPass(program, host_info);
+    PassContext context{
+        .env = env,
+        .host_info = host_info,
+        .options = options,
+        .inst_pool = &arena.InstPool(),
+    };
+    Optimization::RunPasses(TRANSLATION_PIPELINE, context, program);
 
     CollectInterpolationInfo(env, program);
     AddNVNStorageBuffers(program);
@@ -312,7 +452,7 @@ IR::Program TranslateProgram(ObjectPool<IR::Inst>& inst_pool, ObjectPool<IR::Blo
 }
 
 IR::Program MergeDualVertexPrograms(IR::Program& vertex_a, IR::Program& vertex_b,
-                                    Environment& env_vertex_b) {
+                                    Environment& env_vertex_b, const CompileOptions& options) {
     IR::Program result{};
     Optimization::VertexATransformPass(vertex_a);
     Optimization::VertexBTransformPass(vertex_b);
@@ -336,15 +476,24 @@ IR::Program MergeDualVertexPrograms(IR::Program& vertex_a, IR::Program& vertex_b
 
     Optimization::JoinTextureInfo(result.info, vertex_b.info);
     Optimization::JoinStorageInfo(result.info, vertex_b.info);
-    Optimization::DeadCodeEliminationPass(result);
-    if (Settings::values.renderer_debug) {
+    {
+        const PassScope scope{options.instrumentation, "DeadCodeEliminationPass", &result};
+        Optimization::DeadCodeEliminationPass(result);
+    }
+    if (options.renderer_debug) {
+        const PassScope scope{options.instrumentation, "VerificationPass", &result};
         Optimization::VerificationPass(result);
     }
-    Optimization::CollectShaderInfoPass(env_vertex_b, result);
+    {
+        const PassScope scope{options.instrumentation, "CollectShaderInfoPass", &result};
+        Optimization::CollectShaderInfoPass(env_vertex_b, result);
+    }
     return result;
 }
 
 void ConvertLegacyToGeneric(IR::Program& program, const Shader::RuntimeInfo& runtime_info) {
+    // Stores and loads are mapped independently, their instructions are patched in a single walk
+    Optimization::FusedWalk walk;
     auto& stores = program.info.stores;
     if (stores.Legacy()) {
         std::queue<IR::Attribute> unused_output_generics{};
@@ -355,25 +504,13 @@ void ConvertLegacyToGeneric(IR::Program& program, const Shader::RuntimeInfo& run
         }
         program.info.legacy_stores_mapping =
             GenerateLegacyToGenericMappings(stores, unused_output_generics, {});
-        for (IR::Block* const block : program.post_order_blocks) {
-            for (IR::Inst& inst : block->Instructions()) {
-                switch (inst.GetOpcode()) {
-                case IR::Opcode::SetAttribute: {
-                    const auto attr = inst.Arg(0).Attribute();
-                    if (IsLegacyAttribute(attr)) {
-                        stores.Set(program.info.legacy_stores_mapping[attr], true);
-                        inst.SetArg(0, Shader::IR::Value(program.info.legacy_stores_mapping[attr]));
-                    }
-                    break;
-                }
-                default:
-                    break;
-                }
-            }
-        }
+        walk.Add(std::make_unique<LegacyAttributeVisitor>(stores,
+                                                          program.info.legacy_stores_mapping),
+                 Optimization::OpcodeSet{IR::Opcode::SetAttribute});
     }
 
     auto& loads = program.info.loads;
+    std::map<IR::Attribute, IR::Attribute> mappings;
     if (loads.Legacy()) {
         std::queue<IR::Attribute> unused_input_generics{};
         for (size_t index = 0; index < IR::NUM_GENERICS; ++index) {
@@ -383,29 +520,15 @@ void ConvertLegacyToGeneric(IR::Program& program, const Shader::RuntimeInfo& run
                 unused_input_generics.push(IR::Attribute::Generic0X + index * 4);
             }
         }
-        auto mappings = GenerateLegacyToGenericMappings(
+        mappings = GenerateLegacyToGenericMappings(
             loads, unused_input_generics, runtime_info.previous_stage_legacy_stores_mapping);
-        for (IR::Block* const block : program.post_order_blocks) {
-            for (IR::Inst& inst : block->Instructions()) {
-                switch (inst.GetOpcode()) {
-                case IR::Opcode::GetAttribute: {
-                    const auto attr = inst.Arg(0).Attribute();
-                    if (IsLegacyAttribute(attr)) {
-                        loads.Set(mappings[attr], true);
-                        inst.SetArg(0, Shader::IR::Value(mappings[attr]));
-                    }
-                    break;
-                }
-                default:
-                    break;
-                }
-            }
-        }
+        walk.Add(std::make_unique<LegacyAttributeVisitor>(loads, mappings),
+                 Optimization::OpcodeSet{IR::Opcode::GetAttribute});
     }
+    walk.Run(program);
 }
 
-IR::Program GenerateGeometryPassthrough(ObjectPool<IR::Inst>& inst_pool,
-                                        ObjectPool<IR::Block>& block_pool,
+IR::Program GenerateGeometryPassthrough(CompilationArena& arena,
                                         const HostTranslateInfo& host_info,
                                         IR::Program& source_program,
                                         Shader::OutputTopology output_topology) {
@@ -421,7 +544,7 @@ IR::Program GenerateGeometryPassthrough(ObjectPool<IR::Inst>& inst_pool,
     program.info.stores.Set(IR::Attribute::Layer, true);
     program.info.stores.Set(source_program.info.emulated_layer, false);
 
-    IR::Block* current_block = block_pool.Create(inst_pool);
+    IR::Block* current_block = arena.BlockPool().Create(arena);
     auto& node{program.syntax_list.emplace_back()};
     node.type = IR::AbstractSyntaxNode::Type::Block;
     node.data.block = current_block;
@@ -430,7 +553,7 @@ IR::Program GenerateGeometryPassthrough(ObjectPool<IR::Inst>& inst_pool,
     EmitGeometryPassthrough(ir, program, program.info.stores, true,
                             source_program.info.emulated_layer);
 
-    IR::Block* return_block{block_pool.Create(inst_pool)};
+    IR::Block* return_block{arena.BlockPool().Create(arena)};
     IR::IREmitter{*return_block}.Epilogue();
     current_block->AddBranch(return_block);
 
@@ -3,11 +3,12 @@
 
 #pragma once
 
+#include <shader_compiler/compilation_arena.h>
+#include <shader_compiler/compile_options.h>
 #include <shader_compiler/environment.h>
 #include <shader_compiler/frontend/ir/basic_block.h>
 #include <shader_compiler/frontend/ir/program.h>
 #include <shader_compiler/frontend/maxwell/control_flow.h>
-#include <shader_compiler/object_pool.h>
 #include <shader_compiler/runtime_info.h>
 
 namespace Shader {
@@ -16,20 +17,21 @@ struct HostTranslateInfo;
 
 namespace Shader::Maxwell {
 
-[[nodiscard]] IR::Program TranslateProgram(ObjectPool<IR::Inst>& inst_pool,
-                                           ObjectPool<IR::Block>& block_pool, Environment& env,
-                                           Flow::CFG& cfg, const HostTranslateInfo& host_info);
+/// Translates a program into IR, everything the program references is allocated from the arena
+[[nodiscard]] IR::Program TranslateProgram(CompilationArena& arena, Environment& env,
+                                           Flow::CFG& cfg, const HostTranslateInfo& host_info,
+                                           const CompileOptions& options);
 
 [[nodiscard]] IR::Program MergeDualVertexPrograms(IR::Program& vertex_a, IR::Program& vertex_b,
-                                                  Environment& env_vertex_b);
+                                                  Environment& env_vertex_b,
+                                                  const CompileOptions& options);
 
 void ConvertLegacyToGeneric(IR::Program& program, const RuntimeInfo& runtime_info);
 
 // Maxwell v1 and older Nvidia cards don't support setting gl_Layer from non-geometry stages.
 // This creates a workaround by setting the layer as a generic output and creating a
 // passthrough geometry shader that reads the generic and sets the layer.
-[[nodiscard]] IR::Program GenerateGeometryPassthrough(ObjectPool<IR::Inst>& inst_pool,
-                                                      ObjectPool<IR::Block>& block_pool,
+[[nodiscard]] IR::Program GenerateGeometryPassthrough(CompilationArena& arena,
                                                       const HostTranslateInfo& host_info,
                                                       IR::Program& source_program,
                                                       Shader::OutputTopology output_topology);
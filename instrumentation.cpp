@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2026 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <exception>
+
+#include <fmt/format.h>
+
+#include <shader_compiler/frontend/ir/basic_block.h>
+#include <shader_compiler/frontend/ir/program.h>
+#include <shader_compiler/instrumentation.h>
+
+namespace Shader {
+namespace {
+size_t NumLiveInsts(const IR::Program* program) {
+    if (!program) {
+        return 0;
+    }
+    size_t num_insts{};
+    for (const IR::Block* const block : program->blocks) {
+        num_insts += block->Instructions().size();
+    }
+    return num_insts;
+}
+} // Anonymous namespace
+
+void InstrumentationReport::Record(const PassStatistics& statistics) {
+    passes.push_back(statistics);
+}
+
+std::chrono::nanoseconds InstrumentationReport::TotalDuration() const noexcept {
+    std::chrono::nanoseconds total{};
+    for (const PassStatistics& pass : passes) {
+        total += pass.duration;
+    }
+    return total;
+}
+
+std::string InstrumentationReport::ToJson(u64 shader_hash) const {
+    std::string json{fmt::format("{{\"shader\":\"{:016x}\",\"total_ns\":{},\"passes\":[",
+                                 shader_hash, TotalDuration().count())};
+    for (size_t index = 0; index < passes.size(); ++index) {
+        const PassStatistics& pass{passes[index]};
+        json += fmt::format("{}{{\"name\":\"{}\",\"ns\":{},\"visited\":{},\"created\":{},"
+                            "\"removed\":{}}}",
+                            index == 0 ? "" : ",", pass.name, pass.duration.count(),
+                            pass.visited_insts, pass.created_insts, pass.removed_insts);
+    }
+    json += "]}";
+    return json;
+}
+
+void PassScope::Begin(std::string_view name_, const IR::Program* program_,
+                      const ObjectPool<IR::Inst>* inst_pool_) {
+    name = name_;
+    program = program_;
+    inst_pool = inst_pool_;
+    live_insts = NumLiveInsts(program);
+    pool_insts = inst_pool ? inst_pool->NumObjects() : 0;
+    uncaught_exceptions = std::uncaught_exceptions();
+    start = std::chrono::steady_clock::now();
+}
+
+void PassScope::End() {
+    const auto end{std::chrono::steady_clock::now()};
+    if (std::uncaught_exceptions() != uncaught_exceptions) {
+        // The pass threw, its statistics would be meaningless
+        return;
+    }
+    const size_t end_live_insts{NumLiveInsts(program)};
+    PassStatistics statistics{
+        .name = name,
+        .duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start),
+        .visited_insts = live_insts,
+    };
+    if (inst_pool) {
+        // Every instruction is allocated from the pool, whatever isn't live anymore was removed
+        statistics.created_insts = inst_pool->NumObjects() - pool_insts;
+        if (program && live_insts + statistics.created_insts > end_live_insts) {
+            statistics.removed_insts = live_insts + statistics.created_insts - end_live_insts;
+        }
+    } else if (end_live_insts > live_insts) {
+        statistics.created_insts = end_live_insts - live_insts;
+    } else {
+        statistics.removed_insts = live_insts - end_live_insts;
+    }
+    sink->Record(statistics);
+}
+
+} // namespace Shader
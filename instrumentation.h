@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2026 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <chrono>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <shader_compiler/common/common_types.h>
+#include <shader_compiler/frontend/ir/value.h>
+#include <shader_compiler/object_pool.h>
+
+namespace Shader::IR {
+struct Program;
+}
+
+namespace Shader {
+
+/// Statistics of a single pass or phase of a compilation
+struct PassStatistics {
+    std::string_view name; //!< A static string naming the pass
+    std::chrono::nanoseconds duration{};
+    size_t visited_insts{}; //!< Instructions in the program when the pass started
+    size_t created_insts{};
+    size_t removed_insts{};
+};
+
+/**
+ * @brief Receives the statistics of every pass of a compilation, it's supplied through
+ * CompileOptions and is called on the thread performing the compilation
+ * @note A sink shared between concurrent compilations must synchronize itself
+ */
+class InstrumentationSink {
+public:
+    virtual ~InstrumentationSink() = default;
+
+    virtual void Record(const PassStatistics& statistics) = 0;
+};
+
+/// A sink collecting the statistics of a single shader which can be exported as a report
+class InstrumentationReport final : public InstrumentationSink {
+public:
+    void Record(const PassStatistics& statistics) override;
+
+    [[nodiscard]] std::span<const PassStatistics> Passes() const noexcept {
+        return passes;
+    }
+
+    [[nodiscard]] std::chrono::nanoseconds TotalDuration() const noexcept;
+
+    /// Exports the report as a JSON object, the shader hash is used to identify the shader
+    [[nodiscard]] std::string ToJson(u64 shader_hash) const;
+
+    void Clear() noexcept {
+        passes.clear();
+    }
+
+private:
+    std::vector<PassStatistics> passes;
+};
+
+/**
+ * @brief Measures the pass running during its lifetime and records it in the sink on destruction
+ * @note Nothing is measured without a sink, this keeps the cost of disabled instrumentation to a
+ * single branch per pass
+ */
+class PassScope {
+public:
+    explicit PassScope(InstrumentationSink* sink_, std::string_view name_,
+                       const IR::Program* program_ = nullptr,
+                       const ObjectPool<IR::Inst>* inst_pool_ = nullptr)
+        : sink{sink_} {
+        if (sink) {
+            Begin(name_, program_, inst_pool_);
+        }
+    }
+
+    ~PassScope() {
+        if (sink) {
+            End();
+        }
+    }
+
+    PassScope(const PassScope&) = delete;
+    PassScope& operator=(const PassScope&) = delete;
+
+private:
+    void Begin(std::string_view name_, const IR::Program* program_,
+               const ObjectPool<IR::Inst>* inst_pool_);
+
+    void End();
+
+    InstrumentationSink* sink;
+    std::string_view name;
+    const IR::Program* program{};
+    const ObjectPool<IR::Inst>* inst_pool{};
+    std::chrono::steady_clock::time_point start;
+    size_t live_insts{};
+    size_t pool_insts{};
+    int uncaught_exceptions{};
+};
+
+} // namespace Shader
@@ -7,6 +7,7 @@
 #include <shader_compiler/frontend/ir/modifiers.h>
 #include <shader_compiler/frontend/ir/program.h>
 #include <shader_compiler/frontend/ir/value.h>
+#include <shader_compiler/ir_opt/fused_walk.h>
 #include <shader_compiler/ir_opt/passes.h>
 #include <shader_compiler/shader_info.h>
 
@@ -843,12 +844,6 @@ void VisitCbufs(Info& info, IR::Inst& inst) {
     }
 }
 
-void Visit(Info& info, IR::Inst& inst) {
-    VisitUsages(info, inst);
-    VisitFpModifiers(info, inst);
-    VisitCbufs(info, inst);
-}
-
 void GatherInfoFromHeader(Environment& env, Info& info) {
     Stage stage{env.ShaderStage()};
     if (stage == Stage::Compute) {
@@ -933,9 +928,31 @@ void GatherInfoFromHeader(Environment& env, Info& info) {
         // TODO: Legacy varyings
     }
 }
+
+/// Gathers the features and resources used by every instruction of a program
+class ShaderInfoVisitor final : public InstructionVisitor {
+public:
+    static constexpr OpcodeSet OPCODES{OpcodeSet::All()};
+
+    ShaderInfoVisitor(Environment& env_, Info& info_) : env{env_}, info{info_} {}
+
+    void Visit(IR::Block&, IR::Inst& inst) override {
+        VisitUsages(info, inst);
+        VisitFpModifiers(info, inst);
+        VisitCbufs(info, inst);
+    }
+
+    void Finish() override {
+        GatherInfoFromHeader(env, info);
+    }
+
+private:
+    Environment& env;
+    Info& info;
+};
 } // Anonymous namespace
 
-void CollectShaderInfoPass(Environment& env, IR::Program& program) {
+void RegisterCollectShaderInfoPass(FusedWalk& walk, Environment& env, IR::Program& program) {
     Info& info{program.info};
     const u32 base{[&] {
         switch (program.stage) {
@@ -956,13 +973,13 @@ void CollectShaderInfoPass(Environment& env, IR::Program& program) {
         throw InvalidArgument("Invalid stage {}", program.stage);
     }()};
     info.nvn_buffer_base = base;
+    walk.Emplace<ShaderInfoVisitor>(env, info);
+}
 
-    for (IR::Block* const block : program.post_order_blocks) {
-        for (IR::Inst& inst : block->Instructions()) {
-            Visit(info, inst);
-        }
-    }
-    GatherInfoFromHeader(env, info);
+void CollectShaderInfoPass(Environment& env, IR::Program& program) {
+    FusedWalk walk;
+    RegisterCollectShaderInfoPass(walk, env, program);
+    walk.Run(program);
 }
 
 } // namespace Shader::Optimization
@@ -3,11 +3,14 @@
 
 #include <range/v3/algorithm.hpp>
 #include <algorithm>
+#include <array>
 #include <functional>
 #include <tuple>
 #include <type_traits>
+#include <vector>
 
 #include <shader_compiler/common/bit_cast.h>
+#include <shader_compiler/compile_options.h>
 #include <shader_compiler/environment.h>
 #include <shader_compiler/exception.h>
 #include <shader_compiler/frontend/ir/ir_emitter.h>
@@ -43,8 +46,18 @@ template <typename T>
     }
 }
 
+/// Makes an immediate value, wide immediates are allocated from the memory of the block
+template <typename T>
+[[nodiscard]] IR::Value Immediate(IR::Block& block, T value) {
+    if constexpr (std::is_same_v<T, u64> || std::is_same_v<T, f64>) {
+        return IR::Value{value, block.Memory()};
+    } else {
+        return IR::Value{value};
+    }
+}
+
 template <typename T, typename ImmFn>
-bool FoldCommutative(IR::Inst& inst, ImmFn&& imm_fn) {
+bool FoldCommutative(IR::Block& block, IR::Inst& inst, ImmFn&& imm_fn) {
     const IR::Value lhs{inst.Arg(0)};
     const IR::Value rhs{inst.Arg(1)};
 
@@ -53,7 +66,7 @@ bool FoldCommutative(IR::Inst& inst, ImmFn&& imm_fn) {
 
     if (is_lhs_immediate && is_rhs_immediate) {
         const auto result{imm_fn(Arg<T>(lhs), Arg<T>(rhs))};
-        inst.ReplaceUsesWith(IR::Value{result});
+        inst.ReplaceUsesWith(Immediate(block, result));
         return false;
     }
     if (is_lhs_immediate && !is_rhs_immediate) {
@@ -61,7 +74,7 @@ bool FoldCommutative(IR::Inst& inst, ImmFn&& imm_fn) {
         if (rhs_inst->GetOpcode() == inst.GetOpcode() && rhs_inst->Arg(1).IsImmediate()) {
             const auto combined{imm_fn(Arg<T>(lhs), Arg<T>(rhs_inst->Arg(1)))};
             inst.SetArg(0, rhs_inst->Arg(0));
-            inst.SetArg(1, IR::Value{combined});
+            inst.SetArg(1, Immediate(block, combined));
         } else {
             // Normalize
             inst.SetArg(0, rhs);
@@ -73,7 +86,7 @@ bool FoldCommutative(IR::Inst& inst, ImmFn&& imm_fn) {
         if (lhs_inst->GetOpcode() == inst.GetOpcode() && lhs_inst->Arg(1).IsImmediate()) {
             const auto combined{imm_fn(Arg<T>(rhs), Arg<T>(lhs_inst->Arg(1)))};
             inst.SetArg(0, lhs_inst->Arg(0));
-            inst.SetArg(1, IR::Value{combined});
+            inst.SetArg(1, Immediate(block, combined));
         }
     }
     return true;
@@ -339,7 +352,7 @@ void FoldAdd(IR::Block& block, IR::Inst& inst) {
     if (inst.HasAssociatedPseudoOperation()) {
         return;
     }
-    if (!FoldCommutative<T>(inst, [](T a, T b) { return a + b; })) {
+    if (!FoldCommutative<T>(block, inst, [](T a, T b) { return a + b; })) {
         return;
     }
     const IR::Value rhs{inst.Arg(1)};
@@ -444,8 +457,8 @@ void FoldFPMul32(IR::Inst& inst) {
     }
 }
 
-void FoldLogicalAnd(IR::Inst& inst) {
-    if (!FoldCommutative<bool>(inst, [](bool a, bool b) { return a && b; })) {
+void FoldLogicalAnd(IR::Block& block, IR::Inst& inst) {
+    if (!FoldCommutative<bool>(block, inst, [](bool a, bool b) { return a && b; })) {
         return;
     }
     const IR::Value rhs{inst.Arg(1)};
@@ -458,8 +471,8 @@ void FoldLogicalAnd(IR::Inst& inst) {
     }
 }
 
-void FoldLogicalOr(IR::Inst& inst) {
-    if (!FoldCommutative<bool>(inst, [](bool a, bool b) { return a || b; })) {
+void FoldLogicalOr(IR::Block& block, IR::Inst& inst) {
+    if (!FoldCommutative<bool>(block, inst, [](bool a, bool b) { return a || b; })) {
         return;
     }
     const IR::Value rhs{inst.Arg(1)};
@@ -747,9 +760,9 @@ void ConstantPropagation(Environment& env, IR::Block& block, IR::Inst& inst) {
     case IR::Opcode::FPMul32:
         return FoldFPMul32(inst);
     case IR::Opcode::LogicalAnd:
-        return FoldLogicalAnd(inst);
+        return FoldLogicalAnd(block, inst);
     case IR::Opcode::LogicalOr:
-        return FoldLogicalOr(inst);
+        return FoldLogicalOr(block, inst);
     case IR::Opcode::LogicalNot:
         return FoldLogicalNot(inst);
     case IR::Opcode::SLessThan:
@@ -864,16 +877,268 @@ void ConstantPropagation(Environment& env, IR::Block& block, IR::Inst& inst) {
     }
 }
 
-} // Anonymous namespace
+/**
+ * @brief Sparse conditional constant propagation on top of the instruction folders
+ * @note Folding is destructive, so the lattice is pessimistic: instructions are folded when their
+ * arguments are proven constant and phis only when every incoming edge still reachable carries the
+ * same immediate. Edges are killed as branch conditions fold, which may let more phis fold.
+ * Every instruction is revisited at most once per argument replaced, so this converges in linear
+ * time. Branch conditions left as immediates are the dead edges later removed from the program.
+ * @note Loops with a true repeat condition still reach their merge block while loop safety checks
+ * are emitted, so that edge is only killed when they're disabled
+ */
+class SparseConditionalPropagation {
+public:
+    explicit SparseConditionalPropagation(Environment& env_, IR::Program& program_,
+                                          const CompileOptions& options)
+        : env{env_}, program{program_},
+          has_loop_safety_checks{!options.disable_shader_loop_safety_checks} {
+        blocks.resize(IR::NumBlockOrders(program));
+        for (IR::Block* const block : program.post_order_blocks) {
+            BlockState& state{blocks[block->GetOrder()]};
+            state.block = block;
+            state.is_dead = false;
+        }
+        FindBranches();
+    }
+
+    void Run() {
+        // Arguments are defined before their users outside of phis, a first sweep in reverse
+        // post order folds everything not depending on a back edge without tracking users
+        const auto end{program.post_order_blocks.rend()};
+        for (auto it = program.post_order_blocks.rbegin(); it != end; ++it) {
+            IR::Block* const block{*it};
+            BlockState& state{blocks[block->GetOrder()]};
+            if (state.is_dead) {
+                continue;
+            }
+            IR::Block::InstructionList& list{block->Instructions()};
+            for (auto inst_it{list.begin()}; inst_it != list.end();) {
+                IR::Inst& inst{*inst_it};
+                ++inst_it;
+                if (inst.GetOpcode() != IR::Opcode::Phi) {
+                    ConstantPropagation(env, *block, inst);
+                } else if (!VisitPhi(*block, inst) && HasUnsweptPred(*block)) {
+                    // Back edge arguments are folded later in the sweep, try again then
+                    worklist.push_back(&inst);
+                }
+            }
+            state.is_swept = true;
+            EvaluateBranch(*block);
+        }
+        if (worklist.empty()) {
+            return;
+        }
+        // Instructions are tagged with their block while revisiting them, the tag is stored as
+        // the host definition which is unused until the backends
+        for (const BlockState& state : blocks) {
+            if (state.is_dead) {
+                continue;
+            }
+            for (IR::Inst& inst : state.block->Instructions()) {
+                inst.SetDefinition(state.block->GetOrder() + 1);
+            }
+        }
+        while (!worklist.empty()) {
+            IR::Inst* const inst{worklist.back()};
+            worklist.pop_back();
+            // Instructions created by the folders aren't tagged
+            const u32 block_id{inst->Definition<u32>()};
+            const IR::Opcode opcode{inst->GetOpcode()};
+            if (block_id == 0 || opcode == IR::Opcode::Void || opcode == IR::Opcode::Identity) {
+                continue;
+            }
+            BlockState& state{blocks[block_id - 1]};
+            if (state.is_dead) {
+                continue;
+            }
+            Visit(*state.block, *inst);
+            if (opcode == IR::Opcode::ConditionRef) {
+                EvaluateBranch(*state.block);
+            }
+        }
+        for (IR::Block* const block : program.blocks) {
+            for (IR::Inst& inst : block->Instructions()) {
+                inst.SetDefinition<u32>(0);
+            }
+        }
+    }
+
+private:
+    struct BlockState {
+        IR::Block* block{};
+        /// The condition of the branch ending the block, true branches to the first target
+        IR::U1 cond{};
+        std::array<IR::Block*, 2> targets{};
+        /// The successor which is proven to never be branched to
+        IR::Block* dead_target{};
+        bool is_repeat{};
+        bool is_dead{true};
+        bool is_swept{};
+    };
+
+    /// Finds the conditional branches from the abstract syntax list, the block ending with one is
+    /// the last block node before it
+    void FindBranches() {
+        IR::Block* current_block{};
+        for (const IR::AbstractSyntaxNode& node : program.syntax_list) {
+            IR::U1 cond;
+            std::array<IR::Block*, 2> targets{};
+            bool is_repeat{};
+            switch (node.type) {
+            case IR::AbstractSyntaxNode::Type::Block:
+                current_block = node.data.block;
+                continue;
+            case IR::AbstractSyntaxNode::Type::If:
+                cond = node.data.if_node.cond;
+                targets = {node.data.if_node.body, node.data.if_node.merge};
+                break;
+            case IR::AbstractSyntaxNode::Type::Break:
+                cond = node.data.break_node.cond;
+                targets = {node.data.break_node.merge, node.data.break_node.skip};
+                break;
+            case IR::AbstractSyntaxNode::Type::Repeat:
+                cond = node.data.repeat.cond;
+                targets = {node.data.repeat.loop_header, node.data.repeat.merge};
+                is_repeat = true;
+                break;
+            default:
+                continue;
+            }
+            if (!current_block || targets[0] == targets[1]) {
+                continue;
+            }
+            BlockState& state{blocks[current_block->GetOrder()]};
+            state.cond = cond;
+            state.targets = targets;
+            state.is_repeat = is_repeat;
+        }
+    }
 
-void ConstantPropagationPass(Environment& env, IR::Program& program) {
-    const auto end{program.post_order_blocks.rend()};
-    for (auto it = program.post_order_blocks.rbegin(); it != end; ++it) {
-        IR::Block* const block{*it};
-        for (IR::Inst& inst : block->Instructions()) {
-            ConstantPropagation(env, *block, inst);
+    /// Folds an instruction, its users are revisited if it's replaced
+    void Visit(IR::Block& block, IR::Inst& inst) {
+        users.clear();
+        for (IR::Inst* const user : inst.Users()) {
+            users.push_back(user);
         }
+        if (inst.GetOpcode() == IR::Opcode::Phi) {
+            VisitPhi(block, inst);
+        } else {
+            ConstantPropagation(env, block, inst);
+        }
+        const IR::Opcode opcode{inst.GetOpcode()};
+        if (opcode == IR::Opcode::Identity || opcode == IR::Opcode::Void) {
+            worklist.insert(worklist.end(), users.begin(), users.end());
+        }
+    }
+
+    /// Folds a phi into the only immediate reaching it
+    bool VisitPhi(IR::Block& block, IR::Inst& phi) {
+        IR::Value value;
+        const size_t num_args{phi.NumArgs()};
+        for (size_t index = 0; index < num_args; ++index) {
+            if (IsDeadEdge(*phi.PhiBlock(index), block)) {
+                continue;
+            }
+            const IR::Value arg{phi.Arg(index).Resolve()};
+            if (arg == IR::Value{&phi}) {
+                continue;
+            }
+            if (!arg.IsImmediate() || (!value.IsEmpty() && arg != value)) {
+                return false;
+            }
+            value = arg;
+        }
+        if (value.IsEmpty()) {
+            return false;
+        }
+        phi.ReplaceUsesWith(value);
+        phi.Invalidate();
+        block.Instructions().erase(IR::Block::InstructionList::s_iterator_to(phi));
+        return true;
     }
+
+    bool HasUnsweptPred(const IR::Block& block) const {
+        return std::ranges::any_of(block.ImmPredecessors(), [&](const IR::Block* pred) {
+            return !blocks[pred->GetOrder()].is_swept && !IsDeadEdge(*pred, block);
+        });
+    }
+
+    void EvaluateBranch(IR::Block& block) {
+        BlockState& state{blocks[block.GetOrder()]};
+        if (state.cond.IsEmpty() || state.dead_target) {
+            return;
+        }
+        IR::Value cond{state.cond.Resolve()};
+        if (!cond.IsImmediate() && cond.InstRecursive()->GetOpcode() == IR::Opcode::ConditionRef) {
+            cond = cond.InstRecursive()->Arg(0).Resolve();
+        }
+        if (!cond.IsImmediate()) {
+            return;
+        }
+        if (cond.U1() && state.is_repeat && has_loop_safety_checks) {
+            // The safety check may still exit the loop through its merge block
+            return;
+        }
+        state.dead_target = state.targets[cond.U1() ? 1 : 0];
+        EdgeKilled(*state.dead_target);
+    }
+
+    bool IsDeadEdge(const IR::Block& pred, const IR::Block& block) const {
+        const u32 order{pred.GetOrder()};
+        if (order >= blocks.size()) {
+            return true;
+        }
+        const BlockState& state{blocks[order]};
+        return state.is_dead || state.dead_target == &block;
+    }
+
+    /// Kills the blocks left without a live incoming edge, the phis of the others are revisited
+    void EdgeKilled(IR::Block& target) {
+        dead_blocks.clear();
+        dead_blocks.push_back(&target);
+        while (!dead_blocks.empty()) {
+            IR::Block* const block{dead_blocks.back()};
+            dead_blocks.pop_back();
+            BlockState& state{blocks[block->GetOrder()]};
+            if (state.is_dead) {
+                continue;
+            }
+            const auto preds{block->ImmPredecessors()};
+            const bool has_live_pred{std::ranges::any_of(
+                preds, [&](const IR::Block* pred) { return !IsDeadEdge(*pred, *block); })};
+            if (has_live_pred || preds.empty()) {
+                if (!state.is_swept) {
+                    // The phis are folded once the sweep reaches the block
+                    continue;
+                }
+                for (IR::Inst& inst : block->Instructions()) {
+                    if (inst.GetOpcode() != IR::Opcode::Phi) {
+                        break;
+                    }
+                    worklist.push_back(&inst);
+                }
+                continue;
+            }
+            state.is_dead = true;
+            dead_blocks.insert(dead_blocks.end(), block->ImmSuccessors().begin(),
+                               block->ImmSuccessors().end());
+        }
+    }
+
+    Environment& env;
+    IR::Program& program;
+    bool has_loop_safety_checks;
+    std::vector<BlockState> blocks;
+    std::vector<IR::Inst*> worklist;
+    std::vector<IR::Inst*> users;
+    std::vector<IR::Block*> dead_blocks;
+};
+} // Anonymous namespace
+
+void ConstantPropagationPass(Environment& env, IR::Program& program,
+                             const CompileOptions& options) {
+    SparseConditionalPropagation{env, program, options}.Run();
 }
 
 } // namespace Shader::Optimization
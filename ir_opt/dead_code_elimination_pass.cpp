@@ -1,23 +1,71 @@
 // SPDX-FileCopyrightText: Copyright 2021 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <vector>
+
 #include <shader_compiler/frontend/ir/basic_block.h>
 #include <shader_compiler/frontend/ir/value.h>
 #include <shader_compiler/ir_opt/passes.h>
 
 namespace Shader::Optimization {
+namespace {
+// Instructions are marked through their host definition, which is unused until the backends
+constexpr u32 LIVE_BIT{1 << 0};
+constexpr u32 VISITED_BIT{1 << 1};
+
+/// Marks the arguments of a live instruction, those already visited must be revisited
+void MarkArgs(std::vector<IR::Inst*>& worklist, const IR::Inst& inst) {
+    const size_t num_args{inst.NumArgs()};
+    for (size_t index = 0; index < num_args; ++index) {
+        const IR::Value arg{inst.Arg(index)};
+        if (arg.IsImmediate()) {
+            continue;
+        }
+        IR::Inst* const arg_inst{arg.Inst()};
+        const u32 mark{arg_inst->Definition<u32>()};
+        if ((mark & LIVE_BIT) != 0) {
+            continue;
+        }
+        arg_inst->SetDefinition(mark | LIVE_BIT);
+        if ((mark & VISITED_BIT) != 0) {
+            worklist.push_back(arg_inst);
+        }
+    }
+}
+} // Anonymous namespace
 
 void DeadCodeEliminationPass(IR::Program& program) {
-    // We iterate over the instructions in reverse order.
-    // This is because removing an instruction reduces the number of uses for earlier instructions.
+    // Instructions are live when they have side effects or when a live instruction uses them,
+    // anything else is removed even if it is still used, like phis only feeding each other.
+    // Users mostly come before their arguments when walking backwards in post order, only
+    // arguments reached through back edges have to be revisited.
+    std::vector<IR::Inst*> worklist;
+    for (IR::Block* const block : program.post_order_blocks) {
+        IR::Block::InstructionList& list{block->Instructions()};
+        for (auto it{list.rbegin()}; it != list.rend(); ++it) {
+            const u32 mark{it->Definition<u32>()};
+            it->SetDefinition(mark | VISITED_BIT);
+            if ((mark & LIVE_BIT) != 0 || it->MayHaveSideEffects()) {
+                it->SetDefinition(LIVE_BIT | VISITED_BIT);
+                MarkArgs(worklist, *it);
+            }
+        }
+    }
+    while (!worklist.empty()) {
+        const IR::Inst* const inst{worklist.back()};
+        worklist.pop_back();
+        MarkArgs(worklist, *inst);
+    }
     for (IR::Block* const block : program.post_order_blocks) {
-        auto it{block->end()};
-        while (it != block->begin()) {
-            --it;
-            if (!it->HasUses() && !it->MayHaveSideEffects()) {
-                it->Invalidate();
-                it = block->Instructions().erase(it);
+        IR::Block::InstructionList& list{block->Instructions()};
+        for (auto it{list.begin()}; it != list.end();) {
+            if ((it->Definition<u32>() & LIVE_BIT) != 0) {
+                it->SetDefinition<u32>(0);
+                ++it;
+                continue;
             }
+            it->Invalidate();
+            it = list.erase(it);
         }
     }
 }
@@ -0,0 +1,42 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2026 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <bit>
+
+#include <shader_compiler/exception.h>
+#include <shader_compiler/frontend/ir/basic_block.h>
+#include <shader_compiler/ir_opt/fused_walk.h>
+
+namespace Shader::Optimization {
+
+void FusedWalk::Add(std::unique_ptr<InstructionVisitor> visitor, const OpcodeSet& opcodes) {
+    if (visitors.size() == MAX_VISITORS) {
+        throw LogicError("Too many visitors in a fused walk");
+    }
+    const u8 bit{static_cast<u8>(1U << visitors.size())};
+    for (size_t index = 0; index < NUM_OPCODES; ++index) {
+        if (opcodes.Contains(static_cast<IR::Opcode>(index))) {
+            dispatch[index] |= bit;
+        }
+    }
+    visitors.push_back(std::move(visitor));
+}
+
+void FusedWalk::Run(const IR::Program& program) {
+    if (visitors.empty()) {
+        return;
+    }
+    for (IR::Block* const block : program.post_order_blocks) {
+        for (IR::Inst& inst : block->Instructions()) {
+            for (u32 mask = dispatch[static_cast<size_t>(inst.GetOpcode())]; mask != 0;
+                 mask &= mask - 1) {
+                visitors[std::countr_zero(mask)]->Visit(*block, inst);
+            }
+        }
+    }
+    for (const std::unique_ptr<InstructionVisitor>& visitor : visitors) {
+        visitor->Finish();
+    }
+}
+
+} // namespace Shader::Optimization
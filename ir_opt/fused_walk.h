@@ -0,0 +1,144 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2026 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <array>
+#include <initializer_list>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <shader_compiler/common/common_types.h>
+#include <shader_compiler/frontend/ir/opcodes.h>
+#include <shader_compiler/frontend/ir/program.h>
+
+namespace Shader::Optimization {
+
+constexpr size_t NUM_OPCODES{std::size(IR::Detail::META_TABLE)};
+
+/// A set of opcodes, they're built at compile time from the opcode table in opcodes.inc
+class OpcodeSet {
+public:
+    constexpr OpcodeSet() = default;
+
+    constexpr OpcodeSet(std::initializer_list<IR::Opcode> opcodes) noexcept {
+        for (const IR::Opcode opcode : opcodes) {
+            Insert(opcode);
+        }
+    }
+
+    /// Every opcode whose entry in the opcode table satisfies a predicate
+    template <typename Predicate>
+    [[nodiscard]] static constexpr OpcodeSet Where(Predicate&& predicate) {
+        OpcodeSet set;
+        for (size_t index = 0; index < NUM_OPCODES; ++index) {
+            if (predicate(IR::Detail::META_TABLE[index])) {
+                set.Insert(static_cast<IR::Opcode>(index));
+            }
+        }
+        return set;
+    }
+
+    /// Every opcode with a name starting with a prefix
+    [[nodiscard]] static constexpr OpcodeSet WithPrefix(std::string_view prefix) {
+        return Where([prefix](const IR::Detail::OpcodeMeta& meta) {
+            return meta.name.starts_with(prefix);
+        });
+    }
+
+    [[nodiscard]] static constexpr OpcodeSet All() {
+        return Where([](const IR::Detail::OpcodeMeta&) { return true; });
+    }
+
+    constexpr void Insert(IR::Opcode opcode) noexcept {
+        const size_t index{static_cast<size_t>(opcode)};
+        words[index / 64] |= u64{1} << (index % 64);
+    }
+
+    [[nodiscard]] constexpr bool Contains(IR::Opcode opcode) const noexcept {
+        const size_t index{static_cast<size_t>(opcode)};
+        return ((words[index / 64] >> (index % 64)) & 1) != 0;
+    }
+
+    [[nodiscard]] constexpr OpcodeSet operator|(const OpcodeSet& other) const noexcept {
+        OpcodeSet result{*this};
+        for (size_t word = 0; word < words.size(); ++word) {
+            result.words[word] |= other.words[word];
+        }
+        return result;
+    }
+
+    [[nodiscard]] constexpr OpcodeSet operator-(const OpcodeSet& other) const noexcept {
+        OpcodeSet result{*this};
+        for (size_t word = 0; word < words.size(); ++word) {
+            result.words[word] &= ~other.words[word];
+        }
+        return result;
+    }
+
+private:
+    std::array<u64, (NUM_OPCODES + 63) / 64> words{};
+};
+
+/// Global memory loads, stores and atomics
+constexpr OpcodeSet GLOBAL_MEMORY_OPCODES{OpcodeSet::WithPrefix("LoadGlobal") |
+                                          OpcodeSet::WithPrefix("WriteGlobal") |
+                                          OpcodeSet::WithPrefix("GlobalAtomic")};
+
+/// Global memory instructions which write to memory, atomics included
+constexpr OpcodeSet GLOBAL_MEMORY_WRITE_OPCODES{GLOBAL_MEMORY_OPCODES -
+                                                OpcodeSet::WithPrefix("LoadGlobal")};
+
+/// Bindless texture instructions, their handle has to be tracked to a constant buffer
+constexpr OpcodeSet BINDLESS_TEXTURE_OPCODES{OpcodeSet::WithPrefix("BindlessImage")};
+
+/// Bound and bindless texture instructions which aren't indexed yet
+constexpr OpcodeSet TEXTURE_OPCODES{OpcodeSet::WithPrefix("BoundImage") |
+                                    BINDLESS_TEXTURE_OPCODES};
+
+/**
+ * @brief The scan of a pass over every instruction of a program, it's run along with the scans of
+ * other passes by a fused walk
+ * @note Instructions must not be inserted or removed while visiting, rewrites are deferred to
+ * Finish which runs once every visitor has seen the whole program
+ */
+class InstructionVisitor {
+public:
+    virtual ~InstructionVisitor() = default;
+
+    /// Called for every instruction with an opcode in the set the visitor was registered with
+    virtual void Visit(IR::Block& block, IR::Inst& inst) = 0;
+
+    /// Called after the walk, visitors are finished in the order they were registered
+    virtual void Finish() {}
+};
+
+/**
+ * @brief Walks the instructions of a program once on behalf of several visitors, every
+ * instruction is dispatched through an opcode indexed table to the visitors registered for it
+ * @note Registering passes in pipeline order keeps their rewrites in that order, a pass may only
+ * share a walk with earlier passes if their rewrites can't change what it collects
+ */
+class FusedWalk {
+public:
+    static constexpr size_t MAX_VISITORS{8};
+
+    /// Constructs a visitor which handles the opcodes in its OPCODES member
+    template <typename Visitor, typename... Args>
+    void Emplace(Args&&... args) {
+        Add(std::make_unique<Visitor>(std::forward<Args>(args)...), Visitor::OPCODES);
+    }
+
+    void Add(std::unique_ptr<InstructionVisitor> visitor, const OpcodeSet& opcodes);
+
+    /// Visits every instruction of the program in post order and finishes the visitors
+    void Run(const IR::Program& program);
+
+private:
+    std::array<u8, NUM_OPCODES> dispatch{}; ///< Mask of the visitors handling each opcode
+    std::vector<std::unique_ptr<InstructionVisitor>> visitors;
+};
+
+} // namespace Shader::Optimization
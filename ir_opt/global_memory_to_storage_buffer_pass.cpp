@@ -13,6 +13,7 @@
 #include <shader_compiler/frontend/ir/ir_emitter.h>
 #include <shader_compiler/frontend/ir/value.h>
 #include <shader_compiler/host_translate_info.h>
+#include <shader_compiler/ir_opt/fused_walk.h>
 #include <shader_compiler/ir_opt/passes.h>
 
 namespace Shader::Optimization {
@@ -53,117 +54,6 @@ struct StorageInfo {
     StorageWritesSet writes;
 };
 
-/// Returns true when the instruction is a global memory instruction
-bool IsGlobalMemory(const IR::Inst& inst) {
-    switch (inst.GetOpcode()) {
-    case IR::Opcode::LoadGlobalS8:
-    case IR::Opcode::LoadGlobalU8:
-    case IR::Opcode::LoadGlobalS16:
-    case IR::Opcode::LoadGlobalU16:
-    case IR::Opcode::LoadGlobal32:
-    case IR::Opcode::LoadGlobal64:
-    case IR::Opcode::LoadGlobal128:
-    case IR::Opcode::WriteGlobalS8:
-    case IR::Opcode::WriteGlobalU8:
-    case IR::Opcode::WriteGlobalS16:
-    case IR::Opcode::WriteGlobalU16:
-    case IR::Opcode::WriteGlobal32:
-    case IR::Opcode::WriteGlobal64:
-    case IR::Opcode::WriteGlobal128:
-    case IR::Opcode::GlobalAtomicIAdd32:
-    case IR::Opcode::GlobalAtomicSMin32:
-    case IR::Opcode::GlobalAtomicUMin32:
-    case IR::Opcode::GlobalAtomicSMax32:
-    case IR::Opcode::GlobalAtomicUMax32:
-    case IR::Opcode::GlobalAtomicInc32:
-    case IR::Opcode::GlobalAtomicDec32:
-    case IR::Opcode::GlobalAtomicAnd32:
-    case IR::Opcode::GlobalAtomicOr32:
-    case IR::Opcode::GlobalAtomicXor32:
-    case IR::Opcode::GlobalAtomicExchange32:
-    case IR::Opcode::GlobalAtomicIAdd64:
-    case IR::Opcode::GlobalAtomicSMin64:
-    case IR::Opcode::GlobalAtomicUMin64:
-    case IR::Opcode::GlobalAtomicSMax64:
-    case IR::Opcode::GlobalAtomicUMax64:
-    case IR::Opcode::GlobalAtomicAnd64:
-    case IR::Opcode::GlobalAtomicOr64:
-    case IR::Opcode::GlobalAtomicXor64:
-    case IR::Opcode::GlobalAtomicExchange64:
-    case IR::Opcode::GlobalAtomicIAdd32x2:
-    case IR::Opcode::GlobalAtomicSMin32x2:
-    case IR::Opcode::GlobalAtomicUMin32x2:
-    case IR::Opcode::GlobalAtomicSMax32x2:
-    case IR::Opcode::GlobalAtomicUMax32x2:
-    case IR::Opcode::GlobalAtomicAnd32x2:
-    case IR::Opcode::GlobalAtomicOr32x2:
-    case IR::Opcode::GlobalAtomicXor32x2:
-    case IR::Opcode::GlobalAtomicExchange32x2:
-    case IR::Opcode::GlobalAtomicAddF32:
-    case IR::Opcode::GlobalAtomicAddF16x2:
-    case IR::Opcode::GlobalAtomicAddF32x2:
-    case IR::Opcode::GlobalAtomicMinF16x2:
-    case IR::Opcode::GlobalAtomicMinF32x2:
-    case IR::Opcode::GlobalAtomicMaxF16x2:
-    case IR::Opcode::GlobalAtomicMaxF32x2:
-        return true;
-    default:
-        return false;
-    }
-}
-
-/// Returns true when the instruction is a global memory instruction
-bool IsGlobalMemoryWrite(const IR::Inst& inst) {
-    switch (inst.GetOpcode()) {
-    case IR::Opcode::WriteGlobalS8:
-    case IR::Opcode::WriteGlobalU8:
-    case IR::Opcode::WriteGlobalS16:
-    case IR::Opcode::WriteGlobalU16:
-    case IR::Opcode::WriteGlobal32:
-    case IR::Opcode::WriteGlobal64:
-    case IR::Opcode::WriteGlobal128:
-    case IR::Opcode::GlobalAtomicIAdd32:
-    case IR::Opcode::GlobalAtomicSMin32:
-    case IR::Opcode::GlobalAtomicUMin32:
-    case IR::Opcode::GlobalAtomicSMax32:
-    case IR::Opcode::GlobalAtomicUMax32:
-    case IR::Opcode::GlobalAtomicInc32:
-    case IR::Opcode::GlobalAtomicDec32:
-    case IR::Opcode::GlobalAtomicAnd32:
-    case IR::Opcode::GlobalAtomicOr32:
-    case IR::Opcode::GlobalAtomicXor32:
-    case IR::Opcode::GlobalAtomicExchange32:
-    case IR::Opcode::GlobalAtomicIAdd64:
-    case IR::Opcode::GlobalAtomicSMin64:
-    case IR::Opcode::GlobalAtomicUMin64:
-    case IR::Opcode::GlobalAtomicSMax64:
-    case IR::Opcode::GlobalAtomicUMax64:
-    case IR::Opcode::GlobalAtomicAnd64:
-    case IR::Opcode::GlobalAtomicOr64:
-    case IR::Opcode::GlobalAtomicXor64:
-    case IR::Opcode::GlobalAtomicExchange64:
-    case IR::Opcode::GlobalAtomicIAdd32x2:
-    case IR::Opcode::GlobalAtomicSMin32x2:
-    case IR::Opcode::GlobalAtomicUMin32x2:
-    case IR::Opcode::GlobalAtomicSMax32x2:
-    case IR::Opcode::GlobalAtomicUMax32x2:
-    case IR::Opcode::GlobalAtomicAnd32x2:
-    case IR::Opcode::GlobalAtomicOr32x2:
-    case IR::Opcode::GlobalAtomicXor32x2:
-    case IR::Opcode::GlobalAtomicExchange32x2:
-    case IR::Opcode::GlobalAtomicAddF32:
-    case IR::Opcode::GlobalAtomicAddF16x2:
-    case IR::Opcode::GlobalAtomicAddF32x2:
-    case IR::Opcode::GlobalAtomicMinF16x2:
-    case IR::Opcode::GlobalAtomicMinF32x2:
-    case IR::Opcode::GlobalAtomicMaxF16x2:
-    case IR::Opcode::GlobalAtomicMaxF32x2:
-        return true;
-    default:
-        return false;
-    }
-}
-
 /// Converts a global memory opcode to its storage buffer equivalent
 IR::Opcode GlobalToStorage(IR::Opcode opcode) {
     switch (opcode) {
@@ -392,7 +282,7 @@ void CollectStorageBuffers(IR::Block& block, IR::Inst& inst, StorageInfo& info)
         }
     }
     // Collect storage buffer and the instruction
-    if (IsGlobalMemoryWrite(inst)) {
+    if (GLOBAL_MEMORY_WRITE_OPCODES.Contains(inst.GetOpcode())) {
         info.writes.insert(*storage_buffer);
     }
     info.set.insert(*storage_buffer);
@@ -513,36 +403,56 @@ void Replace(IR::Block& block, IR::Inst& inst, const IR::U32& storage_index,
         throw InvalidArgument("Invalid global memory opcode {}", inst.GetOpcode());
     }
 }
-} // Anonymous namespace
 
-void GlobalMemoryToStorageBufferPass(IR::Program& program, const HostTranslateInfo& host_info) {
-    StorageInfo info;
-    for (IR::Block* const block : program.post_order_blocks) {
-        for (IR::Inst& inst : block->Instructions()) {
-            if (!IsGlobalMemory(inst)) {
-                continue;
-            }
-            CollectStorageBuffers(*block, inst, info);
-        }
-    }
-    for (const StorageBufferAddr& storage_buffer : info.set) {
-        program.info.storage_buffers_descriptors.push_back({
-            .cbuf_index = storage_buffer.index,
-            .cbuf_offset = storage_buffer.offset,
-            .count = 1,
-            .is_written = info.writes.contains(storage_buffer),
-        });
+/// Collects the global memory instructions of a program and replaces them once all are known
+class StorageBufferVisitor final : public InstructionVisitor {
+public:
+    static constexpr OpcodeSet OPCODES{GLOBAL_MEMORY_OPCODES};
+
+    StorageBufferVisitor(IR::Program& program_, const HostTranslateInfo& host_info_)
+        : program{program_}, host_info{host_info_} {}
+
+    void Visit(IR::Block& block, IR::Inst& inst) override {
+        CollectStorageBuffers(block, inst, info);
     }
-    for (const StorageInst& storage_inst : info.to_replace) {
-        const StorageBufferAddr storage_buffer{storage_inst.storage_buffer};
-        const auto it{info.set.find(storage_inst.storage_buffer)};
-        const IR::U32 index{IR::Value{static_cast<u32>(info.set.index_of(it))}};
-        IR::Block* const block{storage_inst.block};
-        IR::Inst* const inst{storage_inst.inst};
-        const IR::U32 offset{
-            StorageOffset(*block, *inst, storage_buffer, host_info.min_ssbo_alignment)};
-        Replace(*block, *inst, index, offset);
+
+    void Finish() override {
+        for (const StorageBufferAddr& storage_buffer : info.set) {
+            program.info.storage_buffers_descriptors.push_back({
+                .cbuf_index = storage_buffer.index,
+                .cbuf_offset = storage_buffer.offset,
+                .count = 1,
+                .is_written = info.writes.contains(storage_buffer),
+            });
+        }
+        for (const StorageInst& storage_inst : info.to_replace) {
+            const StorageBufferAddr storage_buffer{storage_inst.storage_buffer};
+            const auto it{info.set.find(storage_inst.storage_buffer)};
+            const IR::U32 index{IR::Value{static_cast<u32>(info.set.index_of(it))}};
+            IR::Block* const block{storage_inst.block};
+            IR::Inst* const inst{storage_inst.inst};
+            const IR::U32 offset{
+                StorageOffset(*block, *inst, storage_buffer, host_info.min_ssbo_alignment)};
+            Replace(*block, *inst, index, offset);
+        }
     }
+
+private:
+    IR::Program& program;
+    const HostTranslateInfo& host_info;
+    StorageInfo info;
+};
+} // Anonymous namespace
+
+void RegisterGlobalMemoryToStorageBufferPass(FusedWalk& walk, IR::Program& program,
+                                             const HostTranslateInfo& host_info) {
+    walk.Emplace<StorageBufferVisitor>(program, host_info);
+}
+
+void GlobalMemoryToStorageBufferPass(IR::Program& program, const HostTranslateInfo& host_info) {
+    FusedWalk walk;
+    RegisterGlobalMemoryToStorageBufferPass(walk, program, host_info);
+    walk.Run(program);
 }
 
 template <typename Descriptors, typename Descriptor, typename Func>
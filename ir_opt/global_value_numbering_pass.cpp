@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2026 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <algorithm>
+#include <bit>
+#include <vector>
+
+#include <shader_compiler/frontend/ir/basic_block.h>
+#include <shader_compiler/frontend/ir/control_flow_analysis.h>
+#include <shader_compiler/frontend/ir/value.h>
+#include <shader_compiler/ir_opt/passes.h>
+#include <shader_compiler/ir_opt/value_semantics.h>
+
+namespace Shader::Optimization {
+namespace {
+u64 HashInst(const IR::Inst& inst) {
+    u64 hash{static_cast<u64>(inst.GetOpcode()) * 0x9E3779B97F4A7C15ULL ^ inst.Flags<u32>()};
+    const size_t num_args{inst.NumArgs()};
+    for (size_t index = 0; index < num_args; ++index) {
+        hash = (hash ^ inst.Arg(index).Resolve().Hash()) * 0x100000001B3ULL;
+    }
+    return hash ^ (hash >> 29);
+}
+
+bool IsSameValue(const IR::Inst& a, const IR::Inst& b) {
+    if (a.GetOpcode() != b.GetOpcode() || a.Flags<u32>() != b.Flags<u32>()) {
+        return false;
+    }
+    const size_t num_args{a.NumArgs()};
+    for (size_t index = 0; index < num_args; ++index) {
+        if (a.Arg(index).Resolve() != b.Arg(index).Resolve()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Instructions which are available to later instructions, several instructions may compute
+ * the same value as long as none of them dominates the others
+ * @note The table is open addressed and sized up front for every candidate, nothing is ever removed
+ */
+class ValueTable {
+public:
+    explicit ValueTable(size_t num_candidates)
+        : entries(std::bit_ceil(std::max<size_t>(num_candidates * 2, 16))),
+          mask{entries.size() - 1} {}
+
+    /// Finds an instruction computing the same value as the given one in a dominating block
+    IR::Inst* Find(const IR::DominatorTree& dominators, IR::Block* block, const IR::Inst& inst,
+                   u64 hash) const {
+        for (size_t index = hash & mask; entries[index].inst; index = (index + 1) & mask) {
+            const Entry& entry{entries[index]};
+            if (entry.hash == hash && IsSameValue(*entry.inst, inst) &&
+                (entry.block == block || dominators.Dominates(entry.block, block))) {
+                return entry.inst;
+            }
+        }
+        return nullptr;
+    }
+
+    void Insert(IR::Block* block, IR::Inst* inst, u64 hash) {
+        size_t index{hash & mask};
+        while (entries[index].inst) {
+            index = (index + 1) & mask;
+        }
+        entries[index] = Entry{.hash = hash, .inst = inst, .block = block};
+    }
+
+private:
+    struct Entry {
+        u64 hash{};
+        IR::Inst* inst{};
+        IR::Block* block{};
+    };
+
+    std::vector<Entry> entries;
+    size_t mask;
+};
+} // Anonymous namespace
+
+void GlobalValueNumberingPass(IR::Program& program) {
+    size_t num_candidates{};
+    bool writes_attributes{};
+    for (const IR::Block* const block : program.blocks) {
+        for (const IR::Inst& inst : block->Instructions()) {
+            const IR::Opcode opcode{inst.GetOpcode()};
+            num_candidates += SemanticsOf(opcode) != ValueSemantics::Varying ? 1 : 0;
+            writes_attributes |=
+                opcode == IR::Opcode::SetAttribute || opcode == IR::Opcode::SetAttributeIndexed;
+        }
+    }
+    if (num_candidates == 0) {
+        return;
+    }
+    const IR::DominatorTree& dominators{program.analyses.Dominators(program)};
+    ValueTable table{num_candidates};
+    // Dominators are visited first so an instruction is always seen after those it can reuse
+    for (IR::Block* const block : dominators.ReversePostOrder()) {
+        IR::Block::InstructionList& list{block->Instructions()};
+        for (auto it{list.begin()}; it != list.end();) {
+            IR::Inst& inst{*it};
+            if (!IsInvariant(inst.GetOpcode(), writes_attributes)) {
+                ++it;
+                continue;
+            }
+            const u64 hash{HashInst(inst)};
+            IR::Inst* const existing{table.Find(dominators, block, inst, hash)};
+            // Pseudo-operations are bound to a single instruction, those with any are kept
+            if (!existing || inst.HasAssociatedPseudoOperation()) {
+                if (!existing) {
+                    table.Insert(block, &inst, hash);
+                }
+                ++it;
+                continue;
+            }
+            inst.ReplaceUsesWith(IR::Value{existing});
+            it = list.erase(it);
+        }
+    }
+}
+
+} // namespace Shader::Optimization
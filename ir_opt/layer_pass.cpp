@@ -12,6 +12,7 @@
 #include <shader_compiler/frontend/ir/breadth_first_search.h>
 #include <shader_compiler/frontend/ir/ir_emitter.h>
 #include <shader_compiler/host_translate_info.h>
+#include <shader_compiler/ir_opt/fused_walk.h>
 #include <shader_compiler/ir_opt/passes.h>
 #include <shader_compiler/shader_info.h>
 
@@ -38,31 +39,51 @@ static bool PermittedProgramStage(Stage stage) {
     }
 }
 
-void LayerPass(IR::Program& program, const HostTranslateInfo& host_info) {
-    if (host_info.support_viewport_index_layer || !PermittedProgramStage(program.stage)) {
-        return;
-    }
+namespace {
+/// Moves the layer stores to an unused generic, it's only known once every store has been seen
+class LayerVisitor final : public InstructionVisitor {
+public:
+    static constexpr OpcodeSet OPCODES{IR::Opcode::SetAttribute};
 
-    const auto end{program.post_order_blocks.end()};
-    const auto layer_attribute = EmulatedLayerAttribute(program.info.stores);
-    bool requires_layer_emulation = false;
+    explicit LayerVisitor(IR::Program& program_) : program{program_} {}
 
-    for (auto block = program.post_order_blocks.begin(); block != end; ++block) {
-        for (IR::Inst& inst : (*block)->Instructions()) {
-            if (inst.GetOpcode() == IR::Opcode::SetAttribute &&
-                inst.Arg(0).Attribute() == IR::Attribute::Layer) {
-                requires_layer_emulation = true;
-                inst.SetArg(0, IR::Value{layer_attribute});
-            }
+    void Visit(IR::Block&, IR::Inst& inst) override {
+        if (inst.Arg(0).Attribute() == IR::Attribute::Layer) {
+            layer_stores.push_back(&inst);
         }
     }
 
-    if (requires_layer_emulation) {
+    void Finish() override {
+        if (layer_stores.empty()) {
+            return;
+        }
+        const auto layer_attribute = EmulatedLayerAttribute(program.info.stores);
+        for (IR::Inst* const inst : layer_stores) {
+            inst->SetArg(0, IR::Value{layer_attribute});
+        }
         program.info.requires_layer_emulation = true;
         program.info.emulated_layer = layer_attribute;
         program.info.stores.Set(IR::Attribute::Layer, false);
         program.info.stores.Set(layer_attribute, true);
     }
+
+private:
+    IR::Program& program;
+    boost::container::small_vector<IR::Inst*, 4> layer_stores;
+};
+} // Anonymous namespace
+
+void RegisterLayerPass(FusedWalk& walk, IR::Program& program, const HostTranslateInfo& host_info) {
+    if (host_info.support_viewport_index_layer || !PermittedProgramStage(program.stage)) {
+        return;
+    }
+    walk.Emplace<LayerVisitor>(program);
+}
+
+void LayerPass(IR::Program& program, const HostTranslateInfo& host_info) {
+    FusedWalk walk;
+    RegisterLayerPass(walk, program, host_info);
+    walk.Run(program);
 }
 
 } // namespace Shader::Optimization
@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2026 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <algorithm>
+#include <ranges>
+#include <unordered_set>
+
+#include <shader_compiler/frontend/ir/basic_block.h>
+#include <shader_compiler/frontend/ir/control_flow_analysis.h>
+#include <shader_compiler/frontend/ir/value.h>
+#include <shader_compiler/ir_opt/passes.h>
+#include <shader_compiler/ir_opt/value_semantics.h>
+
+namespace Shader::Optimization {
+namespace {
+/**
+ * @brief Finds the block entering a loop, it must only branch to the header so instructions moved
+ * into it run once whenever the loop is entered
+ */
+IR::Block* FindPreheader(const IR::Loop& loop) {
+    IR::Block* preheader{};
+    for (IR::Block* const pred : loop.header->ImmPredecessors()) {
+        if (pred == loop.continue_block) {
+            continue;
+        }
+        if (preheader) {
+            return nullptr;
+        }
+        preheader = pred;
+    }
+    if (!preheader || preheader->ImmSuccessors().size() != 1) {
+        return nullptr;
+    }
+    return preheader;
+}
+
+class Pass {
+public:
+    explicit Pass(IR::Program& program_)
+        : program{program_}, writes_attributes{WritesAttributes(program)} {}
+
+    void HoistInvariants(const IR::Loop& loop) {
+        IR::Block* const preheader{FindPreheader(loop)};
+        if (!preheader) {
+            return;
+        }
+        // The blocks of a loop are contiguous and sorted by order in the program
+        const auto by_order{[](const IR::Block* block) { return block->GetOrder(); }};
+        const auto first{std::ranges::lower_bound(program.blocks, loop.header->GetOrder(), {},
+                                                  by_order)};
+        const auto last{std::ranges::upper_bound(first, program.blocks.end(),
+                                                 loop.continue_block->GetOrder(), {}, by_order)};
+        const std::ranges::subrange blocks{first, last};
+
+        variant_insts.clear();
+        for (IR::Block* const block : blocks) {
+            for (IR::Inst& inst : block->Instructions()) {
+                variant_insts.insert(&inst);
+            }
+        }
+        // Definitions come before their uses in program order, so a single walk sees the
+        // arguments of an instruction hoisted before the instruction itself
+        IR::Block::InstructionList& preheader_list{preheader->Instructions()};
+        for (IR::Block* const block : blocks) {
+            IR::Block::InstructionList& list{block->Instructions()};
+            for (auto it{list.begin()}; it != list.end();) {
+                IR::Inst& inst{*it};
+                if (!IsHoistable(inst)) {
+                    ++it;
+                    continue;
+                }
+                variant_insts.erase(&inst);
+                it = list.erase(it);
+                preheader_list.push_back(inst);
+            }
+        }
+    }
+
+private:
+    bool IsHoistable(const IR::Inst& inst) const {
+        if (!IsInvariant(inst.GetOpcode(), writes_attributes)) {
+            return false;
+        }
+        const size_t num_args{inst.NumArgs()};
+        for (size_t index = 0; index < num_args; ++index) {
+            const IR::Value arg{inst.Arg(index).Resolve()};
+            if (!arg.IsImmediate() && variant_insts.contains(arg.Inst())) {
+                return false;
+            }
+        }
+        // Pseudo-operations must stay next to the instruction producing them
+        return !inst.HasAssociatedPseudoOperation();
+    }
+
+    IR::Program& program;
+    bool writes_attributes;
+    std::unordered_set<const IR::Inst*> variant_insts;
+};
+} // Anonymous namespace
+
+void LoopInvariantCodeMotionPass(IR::Program& program) {
+    const IR::LoopNest& loops{program.analyses.Loops(program)};
+    if (loops.Loops().empty()) {
+        return;
+    }
+    Pass pass{program};
+    // Inner loops are listed after the loops containing them, visiting them first lets their
+    // invariants keep moving out through every enclosing loop they don't depend on
+    for (const IR::Loop& loop : std::views::reverse(loops.Loops())) {
+        pass.HoistInvariants(loop);
+    }
+}
+
+} // namespace Shader::Optimization
@@ -0,0 +1,107 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2026 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <shader_compiler/frontend/ir/basic_block.h>
+#include <shader_compiler/instrumentation.h>
+#include <shader_compiler/ir_opt/fused_walk.h>
+#include <shader_compiler/ir_opt/pass_manager.h>
+
+namespace Shader::Optimization {
+namespace {
+constexpr IR::Type FP16_TYPES{IR::Type::F16 | IR::Type::F16x2 | IR::Type::F16x3 |
+                              IR::Type::F16x4};
+
+constexpr bool UsesType(const IR::Detail::OpcodeMeta& meta, IR::Type types) {
+    if (True(meta.type & types)) {
+        return true;
+    }
+    for (const IR::Type arg_type : meta.arg_types) {
+        if (True(arg_type & types)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+constexpr OpcodeCategory ComputeCategories(IR::Opcode opcode) {
+    const IR::Detail::OpcodeMeta& meta{IR::Detail::META_TABLE[static_cast<size_t>(opcode)]};
+    OpcodeCategory categories{OpcodeCategory::None};
+    if (UsesType(meta, FP16_TYPES)) {
+        categories |= OpcodeCategory::Fp16;
+    }
+    if (UsesType(meta, IR::Type::U64)) {
+        categories |= OpcodeCategory::Int64;
+    }
+    if (GLOBAL_MEMORY_OPCODES.Contains(opcode)) {
+        categories |= OpcodeCategory::GlobalMemory;
+    }
+    if (TEXTURE_OPCODES.Contains(opcode)) {
+        categories |= OpcodeCategory::Texture;
+    }
+    if (opcode == IR::Opcode::SetAttribute) {
+        categories |= OpcodeCategory::SetAttribute;
+    }
+    return categories;
+}
+
+constexpr std::array<OpcodeCategory, NUM_OPCODES> CATEGORY_TABLE{[] {
+    std::array<OpcodeCategory, NUM_OPCODES> table{};
+    for (size_t opcode = 0; opcode < NUM_OPCODES; ++opcode) {
+        table[opcode] = ComputeCategories(static_cast<IR::Opcode>(opcode));
+    }
+    return table;
+}()};
+
+static_assert(CATEGORY_TABLE[static_cast<size_t>(IR::Opcode::FPAdd16)] == OpcodeCategory::Fp16);
+static_assert(CATEGORY_TABLE[static_cast<size_t>(IR::Opcode::BindlessImageFetch)] ==
+              OpcodeCategory::Texture);
+static_assert(True(CATEGORY_TABLE[static_cast<size_t>(IR::Opcode::LoadGlobal32)] &
+                   OpcodeCategory::GlobalMemory));
+} // Anonymous namespace
+
+OpcodeCategory CategoriesOf(IR::Opcode opcode) noexcept {
+    return CATEGORY_TABLE[static_cast<size_t>(opcode)];
+}
+
+OpcodeCategory TakeOpcodeCensus(const IR::Program& program) {
+    OpcodeCategory census{OpcodeCategory::None};
+    for (const IR::Block* const block : program.blocks) {
+        for (const IR::Inst& inst : block->Instructions()) {
+            census |= CategoriesOf(inst.GetOpcode());
+        }
+    }
+    return census;
+}
+
+OpcodeCategory Census(PassContext& context, const IR::Program& program) {
+    if (!context.census) {
+        context.census = TakeOpcodeCensus(program);
+    }
+    return *context.census;
+}
+
+void RunPasses(std::span<const PassDescriptor> pipeline, PassContext& context,
+               IR::Program& program) {
+    for (const PassDescriptor& pass : pipeline) {
+        if (pass.enabled && !pass.enabled(context)) {
+            continue;
+        }
+        if (pass.required_categories != OpcodeCategory::None &&
+            False(Census(context, program) & pass.required_categories)) {
+            continue;
+        }
+        {
+            const PassScope scope{context.options.instrumentation, pass.name, &program,
+                                  context.inst_pool};
+            pass.run(context, program);
+        }
+        if (True(pass.invalidates & Analysis::OpcodeCensus)) {
+            context.census.reset();
+        }
+        if (True(pass.invalidates & Analysis::ControlFlow)) {
+            program.analyses.InvalidateControlFlow();
+        }
+    }
+}
+
+} // namespace Shader::Optimization
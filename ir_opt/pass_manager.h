@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2026 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <array>
+#include <optional>
+#include <span>
+#include <string_view>
+
+#include <shader_compiler/common/common_funcs.h>
+#include <shader_compiler/common/common_types.h>
+#include <shader_compiler/compile_options.h>
+#include <shader_compiler/environment.h>
+#include <shader_compiler/frontend/ir/opcodes.h>
+#include <shader_compiler/frontend/ir/program.h>
+#include <shader_compiler/frontend/ir/value.h>
+#include <shader_compiler/host_translate_info.h>
+#include <shader_compiler/object_pool.h>
+
+namespace Shader::Optimization {
+
+/// Groups of opcodes which passes depend on to have any effect on a program
+enum class OpcodeCategory : u32 {
+    None = 0,
+    Fp16 = 1 << 0,         ///< Opcodes with 16-bit float operands or results
+    Int64 = 1 << 1,        ///< Opcodes with 64-bit integer operands or results
+    GlobalMemory = 1 << 2, ///< Global memory loads, stores and atomics
+    Texture = 1 << 3,      ///< Bound and bindless texture instructions which aren't indexed yet
+    SetAttribute = 1 << 4, ///< Attribute stores
+};
+DECLARE_ENUM_FLAG_OPERATORS(OpcodeCategory)
+
+/// Analyses of a program which are cached by the pass manager
+enum class Analysis : u32 {
+    None = 0,
+    /// The union of the categories of every instruction in the program, it may be a superset of
+    /// them after a pass which doesn't invalidate it removes instructions
+    OpcodeCensus = 1 << 0,
+    ControlFlow = 1 << 1,  ///< Dominance and loop information cached on the program
+};
+DECLARE_ENUM_FLAG_OPERATORS(Analysis)
+
+[[nodiscard]] OpcodeCategory CategoriesOf(IR::Opcode opcode) noexcept;
+
+/// Walks the program once to find the categories of all the instructions in it
+[[nodiscard]] OpcodeCategory TakeOpcodeCensus(const IR::Program& program);
+
+/// State shared by every pass of a pipeline
+struct PassContext {
+    Environment& env;
+    const HostTranslateInfo& host_info;
+    const CompileOptions& options;
+    const ObjectPool<IR::Inst>* inst_pool{}; //!< Used to count created instructions
+    std::optional<OpcodeCategory> census{};  //!< Cached by Census until a pass invalidates it
+};
+
+/// Gets the opcode census of the program, it's only taken when none is cached in the context
+[[nodiscard]] OpcodeCategory Census(PassContext& context, const IR::Program& program);
+
+constexpr size_t MAX_PASS_PREREQUISITES{2};
+
+/**
+ * @brief A declarative description of a pass, the pass manager uses it to decide whether the pass
+ * can change the program at all before running it
+ */
+struct PassDescriptor {
+    std::string_view name;
+    void (*run)(PassContext& context, IR::Program& program);
+    /// Decides if the pass applies to the compilation at all, it always applies when null
+    bool (*enabled)(const PassContext& context){};
+    /// The pass is skipped when the program contains none of these, None always runs the pass
+    OpcodeCategory required_categories{OpcodeCategory::None};
+    /// Passes which must appear earlier in the pipeline, they may still have been skipped
+    std::array<std::string_view, MAX_PASS_PREREQUISITES> prerequisites{};
+    /// Analyses which may miss instructions emitted by the pass and must be recomputed
+    Analysis invalidates{Analysis::None};
+};
+
+/// Checks that every prerequisite of a pass appears before it in the pipeline
+[[nodiscard]] constexpr bool IsValidPipeline(std::span<const PassDescriptor> pipeline) noexcept {
+    for (size_t index = 0; index < pipeline.size(); ++index) {
+        for (const std::string_view& prerequisite : pipeline[index].prerequisites) {
+            if (prerequisite.empty()) {
+                continue;
+            }
+            bool found{};
+            for (size_t previous = 0; previous < index; ++previous) {
+                found |= pipeline[previous].name == prerequisite;
+            }
+            if (!found) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Runs a pipeline of passes in order, passes whose required opcode categories are absent
+ * from the program are skipped since they can't change it
+ * @note Passes sharing a walk can't be skipped as a whole, they check the census themselves
+ * @note The opcode census is taken lazily before the first pass that needs it and is only retaken
+ * after a pass invalidating it, passes never need more than a handful of walks over the program
+ */
+void RunPasses(std::span<const PassDescriptor> pipeline, PassContext& context,
+               IR::Program& program);
+
+} // namespace Shader::Optimization
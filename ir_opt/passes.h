@@ -3,29 +3,49 @@
 
 #pragma once
 
+#include <shader_compiler/common/settings.h>
 #include <shader_compiler/environment.h>
 #include <shader_compiler/frontend/ir/program.h>
 
 namespace Shader {
+struct CompileOptions;
 struct HostTranslateInfo;
 }
 
 namespace Shader::Optimization {
 
+class FusedWalk;
+
 void CollectShaderInfoPass(Environment& env, IR::Program& program);
-void ConstantPropagationPass(Environment& env, IR::Program& program);
+void ConstantBranchFoldingPass(IR::Program& program);
+void ConstantPropagationPass(Environment& env, IR::Program& program,
+                             const CompileOptions& options);
 void DeadCodeEliminationPass(IR::Program& program);
 void GlobalMemoryToStorageBufferPass(IR::Program& program, const HostTranslateInfo& host_info);
+void GlobalValueNumberingPass(IR::Program& program);
 void IdentityRemovalPass(IR::Program& program);
+void LoopInvariantCodeMotionPass(IR::Program& program);
 void LowerFp16ToFp32(IR::Program& program);
 void LowerInt64ToInt32(IR::Program& program);
-void RescalingPass(IR::Program& program);
+void RescalingPass(IR::Program& program, const Settings::ResolutionScalingInfo& scaling);
+void SimplifyControlFlowPass(IR::Program& program);
 void SsaRewritePass(IR::Program& program);
 void PositionPass(Environment& env, IR::Program& program);
 void TexturePass(Environment& env, IR::Program& program, const HostTranslateInfo& host_info);
 void LayerPass(IR::Program& program, const HostTranslateInfo& host_info);
 void VerificationPass(const IR::Program& program);
 
+// Fused walks, these register the scan of a pass on a walk shared with other passes
+void RegisterCollectShaderInfoPass(FusedWalk& walk, Environment& env, IR::Program& program);
+void RegisterGlobalMemoryToStorageBufferPass(FusedWalk& walk, IR::Program& program,
+                                             const HostTranslateInfo& host_info);
+void RegisterLayerPass(FusedWalk& walk, IR::Program& program, const HostTranslateInfo& host_info);
+void RegisterPositionPass(FusedWalk& walk, Environment& env, IR::Program& program);
+void RegisterRescalingPass(FusedWalk& walk, IR::Program& program,
+                           const Settings::ResolutionScalingInfo& scaling);
+void RegisterTexturePass(FusedWalk& walk, Environment& env, IR::Program& program,
+                         const HostTranslateInfo& host_info);
+
 // Dual Vertex
 void VertexATransformPass(IR::Program& program);
 void VertexBTransformPass(IR::Program& program);
@@ -6,6 +6,7 @@
 #include <shader_compiler/frontend/ir/basic_block.h>
 #include <shader_compiler/frontend/ir/ir_emitter.h>
 #include <shader_compiler/frontend/ir/value.h>
+#include <shader_compiler/ir_opt/fused_walk.h>
 #include <shader_compiler/ir_opt/passes.h>
 
 namespace Shader::Optimization {
@@ -17,31 +18,42 @@ struct PositionInst {
     IR::Attribute attr;
 };
 using PositionInstVector = boost::container::small_vector<PositionInst, 24>;
-} // Anonymous namespace
 
-void PositionPass(Environment& env, IR::Program& program) {
-    if (env.ShaderStage() != Stage::VertexB || env.ReadViewportTransformState()) {
-        return;
-    }
+class PositionVisitor final : public InstructionVisitor {
+public:
+    static constexpr OpcodeSet OPCODES{IR::Opcode::SetAttribute};
 
-    Info& info{program.info};
-    info.uses_render_area = true;
+    void Visit(IR::Block& block, IR::Inst& inst) override {
+        const IR::Attribute attr{inst.Arg(0).Attribute()};
+        switch (attr) {
+        case IR::Attribute::PositionX:
+        case IR::Attribute::PositionY: {
+            to_replace.push_back(PositionInst{.inst = &inst, .block = &block, .attr = attr});
+            break;
+        }
+        default:
+            break;
+        }
+    }
 
-    PositionInstVector to_replace;
-    for (IR::Block* const block : program.post_order_blocks) {
-        for (IR::Inst& inst : block->Instructions()) {
-            switch (inst.GetOpcode()) {
-            case IR::Opcode::SetAttribute: {
-                const IR::Attribute attr{inst.Arg(0).Attribute()};
-                switch (attr) {
-                case IR::Attribute::PositionX:
-                case IR::Attribute::PositionY: {
-                    to_replace.push_back(PositionInst{.inst = &inst, .block = block, .attr = attr});
-                    break;
-                }
-                default:
-                    break;
-                }
+    void Finish() override {
+        for (PositionInst& position_inst : to_replace) {
+            IR::IREmitter ir{*position_inst.block,
+                             IR::Block::InstructionList::s_iterator_to(*position_inst.inst)};
+            const IR::F32 value(position_inst.inst->Arg(1));
+            const IR::F32F64 scale(ir.Imm32(2.f));
+            const IR::F32 negative_one{ir.Imm32(-1.f)};
+            switch (position_inst.attr) {
+            case IR::Attribute::PositionX: {
+                position_inst.inst->SetArg(
+                    1, ir.FPFma(value, ir.FPMul(ir.FPRecip(ir.RenderAreaWidth()), scale),
+                                negative_one));
+                break;
+            }
+            case IR::Attribute::PositionY: {
+                position_inst.inst->SetArg(
+                    1, ir.FPFma(value, ir.FPMul(ir.FPRecip(ir.RenderAreaHeight()), scale),
+                                negative_one));
                 break;
             }
             default:
@@ -50,28 +62,22 @@ void PositionPass(Environment& env, IR::Program& program) {
         }
     }
 
-    for (PositionInst& position_inst : to_replace) {
-        IR::IREmitter ir{*position_inst.block,
-                         IR::Block::InstructionList::s_iterator_to(*position_inst.inst)};
-        const IR::F32 value(position_inst.inst->Arg(1));
-        const IR::F32F64 scale(ir.Imm32(2.f));
-        const IR::F32 negative_one{ir.Imm32(-1.f)};
-        switch (position_inst.attr) {
-        case IR::Attribute::PositionX: {
-            position_inst.inst->SetArg(
-                1,
-                ir.FPFma(value, ir.FPMul(ir.FPRecip(ir.RenderAreaWidth()), scale), negative_one));
-            break;
-        }
-        case IR::Attribute::PositionY: {
-            position_inst.inst->SetArg(
-                1,
-                ir.FPFma(value, ir.FPMul(ir.FPRecip(ir.RenderAreaHeight()), scale), negative_one));
-            break;
-        }
-        default:
-            break;
-        }
+private:
+    PositionInstVector to_replace;
+};
+} // Anonymous namespace
+
+void RegisterPositionPass(FusedWalk& walk, Environment& env, IR::Program& program) {
+    if (env.ShaderStage() != Stage::VertexB || env.ReadViewportTransformState()) {
+        return;
     }
+    program.info.uses_render_area = true;
+    walk.Emplace<PositionVisitor>();
+}
+
+void PositionPass(Environment& env, IR::Program& program) {
+    FusedWalk walk;
+    RegisterPositionPass(walk, env, program);
+    walk.Run(program);
 }
 } // namespace Shader::Optimization
@@ -1,12 +1,18 @@
 // SPDX-FileCopyrightText: Copyright 2021 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <utility>
+#include <vector>
+
+#include <boost/container/small_vector.hpp>
+
 #include <shader_compiler/common/settings.h>
 #include <shader_compiler/environment.h>
 #include <shader_compiler/frontend/ir/ir_emitter.h>
 #include <shader_compiler/frontend/ir/modifiers.h>
 #include <shader_compiler/frontend/ir/program.h>
 #include <shader_compiler/frontend/ir/value.h>
+#include <shader_compiler/ir_opt/fused_walk.h>
 #include <shader_compiler/ir_opt/passes.h>
 #include <shader_compiler/shader_info.h>
 
@@ -93,40 +99,44 @@ void PatchPointSize(IR::Block& block, IR::Inst& inst) {
     inst.SetArg(1, upscaled_point_value);
 }
 
-[[nodiscard]] IR::U32 Scale(IR::IREmitter& ir, const IR::U1& is_scaled, const IR::U32& value) {
+[[nodiscard]] IR::U32 Scale(const Settings::ResolutionScalingInfo& scaling, IR::IREmitter& ir,
+                            const IR::U1& is_scaled, const IR::U32& value) {
     IR::U32 scaled_value{value};
-    if (const u32 up_scale = Settings::values.resolution_info.up_scale; up_scale != 1) {
+    if (const u32 up_scale = scaling.up_scale; up_scale != 1) {
         scaled_value = ir.IMul(scaled_value, ir.Imm32(up_scale));
     }
-    if (const u32 down_shift = Settings::values.resolution_info.down_shift; down_shift != 0) {
+    if (const u32 down_shift = scaling.down_shift; down_shift != 0) {
         scaled_value = ir.ShiftRightArithmetic(scaled_value, ir.Imm32(down_shift));
     }
     return IR::U32{ir.Select(is_scaled, scaled_value, value)};
 }
 
-[[nodiscard]] IR::U32 SubScale(IR::IREmitter& ir, const IR::U1& is_scaled, const IR::U32& value,
+[[nodiscard]] IR::U32 SubScale(const Settings::ResolutionScalingInfo& scaling, IR::IREmitter& ir,
+                               const IR::U1& is_scaled, const IR::U32& value,
                                const IR::Attribute attrib) {
-    const IR::F32 up_factor{ir.Imm32(Settings::values.resolution_info.up_factor)};
+    const IR::F32 up_factor{ir.Imm32(scaling.up_factor)};
     const IR::F32 base{ir.FPMul(ir.ConvertUToF(32, 32, value), up_factor)};
     const IR::F32 frag_coord{ir.GetAttribute(attrib)};
-    const IR::F32 down_factor{ir.Imm32(Settings::values.resolution_info.down_factor)};
+    const IR::F32 down_factor{ir.Imm32(scaling.down_factor)};
     const IR::F32 floor{ir.FPMul(up_factor, ir.FPFloor(ir.FPMul(frag_coord, down_factor)))};
     const IR::F16F32F64 deviation{ir.FPAdd(base, ir.FPAdd(frag_coord, ir.FPNeg(floor)))};
     return IR::U32{ir.Select(is_scaled, ir.ConvertFToU(32, deviation), value)};
 }
 
-[[nodiscard]] IR::U32 DownScale(IR::IREmitter& ir, const IR::U1& is_scaled, const IR::U32& value) {
+[[nodiscard]] IR::U32 DownScale(const Settings::ResolutionScalingInfo& scaling, IR::IREmitter& ir,
+                                const IR::U1& is_scaled, const IR::U32& value) {
     IR::U32 scaled_value{value};
-    if (const u32 down_shift = Settings::values.resolution_info.down_shift; down_shift != 0) {
+    if (const u32 down_shift = scaling.down_shift; down_shift != 0) {
         scaled_value = ir.ShiftLeftLogical(scaled_value, ir.Imm32(down_shift));
     }
-    if (const u32 up_scale = Settings::values.resolution_info.up_scale; up_scale != 1) {
+    if (const u32 up_scale = scaling.up_scale; up_scale != 1) {
         scaled_value = ir.IDiv(scaled_value, ir.Imm32(up_scale));
     }
     return IR::U32{ir.Select(is_scaled, scaled_value, value)};
 }
 
-void PatchImageQueryDimensions(IR::Block& block, IR::Inst& inst) {
+void PatchImageQueryDimensions(const Settings::ResolutionScalingInfo& scaling, IR::Block& block,
+                               IR::Inst& inst) {
     const auto it{IR::Block::InstructionList::s_iterator_to(inst)};
     IR::IREmitter ir{block, IR::Block::InstructionList::s_iterator_to(inst)};
     const auto info{inst.Flags<IR::TextureInstInfo>()};
@@ -136,8 +146,10 @@ void PatchImageQueryDimensions(IR::Block& block, IR::Inst& inst) {
     case TextureType::ColorArray2D:
     case TextureType::Color2DRect: {
         const IR::Value new_inst{&*block.PrependNewInst(it, inst)};
-        const IR::U32 width{DownScale(ir, is_scaled, IR::U32{ir.CompositeExtract(new_inst, 0)})};
-        const IR::U32 height{DownScale(ir, is_scaled, IR::U32{ir.CompositeExtract(new_inst, 1)})};
+        const IR::U32 width{
+            DownScale(scaling, ir, is_scaled, IR::U32{ir.CompositeExtract(new_inst, 0)})};
+        const IR::U32 height{
+            DownScale(scaling, ir, is_scaled, IR::U32{ir.CompositeExtract(new_inst, 1)})};
         const IR::Value replacement{ir.CompositeConstruct(
             width, height, ir.CompositeExtract(new_inst, 2), ir.CompositeExtract(new_inst, 3))};
         inst.ReplaceUsesWith(replacement);
@@ -154,15 +166,17 @@ void PatchImageQueryDimensions(IR::Block& block, IR::Inst& inst) {
     }
 }
 
-void ScaleIntegerComposite(IR::IREmitter& ir, IR::Inst& inst, const IR::U1& is_scaled,
-                           size_t index) {
+void ScaleIntegerComposite(const Settings::ResolutionScalingInfo& scaling, IR::IREmitter& ir,
+                           IR::Inst& inst, const IR::U1& is_scaled, size_t index) {
     const IR::Value composite{inst.Arg(index)};
     if (composite.IsEmpty()) {
         return;
     }
     const auto info{inst.Flags<IR::TextureInstInfo>()};
-    const IR::U32 x{Scale(ir, is_scaled, IR::U32{ir.CompositeExtract(composite, 0)})};
-    const IR::U32 y{Scale(ir, is_scaled, IR::U32{ir.CompositeExtract(composite, 1)})};
+    const IR::U32 x{
+        Scale(scaling, ir, is_scaled, IR::U32{ir.CompositeExtract(composite, 0)})};
+    const IR::U32 y{
+        Scale(scaling, ir, is_scaled, IR::U32{ir.CompositeExtract(composite, 1)})};
     switch (info.type) {
     case TextureType::Color2D:
     case TextureType::Color2DRect:
@@ -184,15 +198,18 @@ void ScaleIntegerComposite(IR::IREmitter& ir, IR::Inst& inst, const IR::U1& is_s
     }
 }
 
-void ScaleIntegerOffsetComposite(IR::IREmitter& ir, IR::Inst& inst, const IR::U1& is_scaled,
+void ScaleIntegerOffsetComposite(const Settings::ResolutionScalingInfo& scaling,
+                                 IR::IREmitter& ir, IR::Inst& inst, const IR::U1& is_scaled,
                                  size_t index) {
     const IR::Value composite{inst.Arg(index)};
     if (composite.IsEmpty()) {
         return;
     }
     const auto info{inst.Flags<IR::TextureInstInfo>()};
-    const IR::U32 x{Scale(ir, is_scaled, IR::U32{ir.CompositeExtract(composite, 0)})};
-    const IR::U32 y{Scale(ir, is_scaled, IR::U32{ir.CompositeExtract(composite, 1)})};
+    const IR::U32 x{
+        Scale(scaling, ir, is_scaled, IR::U32{ir.CompositeExtract(composite, 0)})};
+    const IR::U32 y{
+        Scale(scaling, ir, is_scaled, IR::U32{ir.CompositeExtract(composite, 1)})};
     switch (info.type) {
     case TextureType::ColorArray2D:
     case TextureType::Color2D:
@@ -210,14 +227,17 @@ void ScaleIntegerOffsetComposite(IR::IREmitter& ir, IR::Inst& inst, const IR::U1
     }
 }
 
-void SubScaleCoord(IR::IREmitter& ir, IR::Inst& inst, const IR::U1& is_scaled) {
+void SubScaleCoord(const Settings::ResolutionScalingInfo& scaling, IR::IREmitter& ir,
+                   IR::Inst& inst, const IR::U1& is_scaled) {
     const auto info{inst.Flags<IR::TextureInstInfo>()};
     const IR::Value coord{inst.Arg(1)};
     const IR::U32 coord_x{ir.CompositeExtract(coord, 0)};
     const IR::U32 coord_y{ir.CompositeExtract(coord, 1)};
 
-    const IR::U32 scaled_x{SubScale(ir, is_scaled, coord_x, IR::Attribute::PositionX)};
-    const IR::U32 scaled_y{SubScale(ir, is_scaled, coord_y, IR::Attribute::PositionY)};
+    const IR::U32 scaled_x{
+        SubScale(scaling, ir, is_scaled, coord_x, IR::Attribute::PositionX)};
+    const IR::U32 scaled_y{
+        SubScale(scaling, ir, is_scaled, coord_y, IR::Attribute::PositionY)};
     switch (info.type) {
     case TextureType::Color2D:
     case TextureType::Color2DRect:
@@ -239,51 +259,56 @@ void SubScaleCoord(IR::IREmitter& ir, IR::Inst& inst, const IR::U1& is_scaled) {
     }
 }
 
-void SubScaleImageFetch(IR::Block& block, IR::Inst& inst) {
+void SubScaleImageFetch(const Settings::ResolutionScalingInfo& scaling, IR::Block& block,
+                        IR::Inst& inst) {
     IR::IREmitter ir{block, IR::Block::InstructionList::s_iterator_to(inst)};
     const auto info{inst.Flags<IR::TextureInstInfo>()};
     if (!IsTextureTypeRescalable(info.type)) {
         return;
     }
     const IR::U1 is_scaled{ir.IsTextureScaled(ir.Imm32(info.descriptor_index))};
-    SubScaleCoord(ir, inst, is_scaled);
+    SubScaleCoord(scaling, ir, inst, is_scaled);
     // Scale ImageFetch offset
-    ScaleIntegerOffsetComposite(ir, inst, is_scaled, 2);
+    ScaleIntegerOffsetComposite(scaling, ir, inst, is_scaled, 2);
 }
 
-void SubScaleImageRead(IR::Block& block, IR::Inst& inst) {
+void SubScaleImageRead(const Settings::ResolutionScalingInfo& scaling, IR::Block& block,
+                       IR::Inst& inst) {
     IR::IREmitter ir{block, IR::Block::InstructionList::s_iterator_to(inst)};
     const auto info{inst.Flags<IR::TextureInstInfo>()};
     if (!IsTextureTypeRescalable(info.type)) {
         return;
     }
     const IR::U1 is_scaled{ir.IsImageScaled(ir.Imm32(info.descriptor_index))};
-    SubScaleCoord(ir, inst, is_scaled);
+    SubScaleCoord(scaling, ir, inst, is_scaled);
 }
 
-void PatchImageFetch(IR::Block& block, IR::Inst& inst) {
+void PatchImageFetch(const Settings::ResolutionScalingInfo& scaling, IR::Block& block,
+                     IR::Inst& inst) {
     IR::IREmitter ir{block, IR::Block::InstructionList::s_iterator_to(inst)};
     const auto info{inst.Flags<IR::TextureInstInfo>()};
     if (!IsTextureTypeRescalable(info.type)) {
         return;
     }
     const IR::U1 is_scaled{ir.IsTextureScaled(ir.Imm32(info.descriptor_index))};
-    ScaleIntegerComposite(ir, inst, is_scaled, 1);
+    ScaleIntegerComposite(scaling, ir, inst, is_scaled, 1);
     // Scale ImageFetch offset
-    ScaleIntegerOffsetComposite(ir, inst, is_scaled, 2);
+    ScaleIntegerOffsetComposite(scaling, ir, inst, is_scaled, 2);
 }
 
-void PatchImageRead(IR::Block& block, IR::Inst& inst) {
+void PatchImageRead(const Settings::ResolutionScalingInfo& scaling, IR::Block& block,
+                    IR::Inst& inst) {
     IR::IREmitter ir{block, IR::Block::InstructionList::s_iterator_to(inst)};
     const auto info{inst.Flags<IR::TextureInstInfo>()};
     if (!IsTextureTypeRescalable(info.type)) {
         return;
     }
     const IR::U1 is_scaled{ir.IsImageScaled(ir.Imm32(info.descriptor_index))};
-    ScaleIntegerComposite(ir, inst, is_scaled, 1);
+    ScaleIntegerComposite(scaling, ir, inst, is_scaled, 1);
 }
 
-void Visit(const IR::Program& program, IR::Block& block, IR::Inst& inst) {
+void VisitScale(const Settings::ResolutionScalingInfo& scaling, const IR::Program& program,
+                IR::Block& block, IR::Inst& inst) {
     const bool is_fragment_shader{program.stage == Stage::Fragment};
     switch (inst.GetOpcode()) {
     case IR::Opcode::GetAttribute: {
@@ -314,42 +339,86 @@ void Visit(const IR::Program& program, IR::Block& block, IR::Inst& inst) {
         break;
     }
     case IR::Opcode::ImageQueryDimensions:
-        PatchImageQueryDimensions(block, inst);
+        PatchImageQueryDimensions(scaling, block, inst);
         break;
     case IR::Opcode::ImageFetch:
         if (is_fragment_shader) {
-            SubScaleImageFetch(block, inst);
+            SubScaleImageFetch(scaling, block, inst);
         } else {
-            PatchImageFetch(block, inst);
+            PatchImageFetch(scaling, block, inst);
         }
         break;
     case IR::Opcode::ImageRead:
         if (is_fragment_shader) {
-            SubScaleImageRead(block, inst);
+            SubScaleImageRead(scaling, block, inst);
         } else {
-            PatchImageRead(block, inst);
+            PatchImageRead(scaling, block, inst);
         }
         break;
     default:
         break;
     }
 }
-} // Anonymous namespace
 
-void RescalingPass(IR::Program& program) {
-    const bool is_fragment_shader{program.stage == Stage::Fragment};
-    if (is_fragment_shader) {
-        for (IR::Block* const block : program.post_order_blocks) {
-            for (IR::Inst& inst : block->Instructions()) {
-                VisitMark(*block, inst);
-            }
+/**
+ * @brief Marks the position reads which are shuffled, then rescales the program once textures are
+ * indexed
+ * @note The instructions to rescale are collected during the walk, textures indexed by an earlier
+ * visitor keep their instruction as only the opcode is replaced. Texel fetches duplicated while
+ * indexing are buffer fetches, which are never rescaled
+ */
+class RescalingVisitor final : public InstructionVisitor {
+public:
+    static constexpr OpcodeSet SHUFFLE_OPCODES{IR::Opcode::ShuffleIndex, IR::Opcode::ShuffleUp,
+                                               IR::Opcode::ShuffleDown,
+                                               IR::Opcode::ShuffleButterfly};
+    static constexpr OpcodeSet OPCODES{
+        SHUFFLE_OPCODES | OpcodeSet{IR::Opcode::GetAttribute, IR::Opcode::SetAttribute,
+                                    IR::Opcode::ImageQueryDimensions, IR::Opcode::ImageFetch,
+                                    IR::Opcode::ImageRead, IR::Opcode::BoundImageQueryDimensions,
+                                    IR::Opcode::BindlessImageQueryDimensions,
+                                    IR::Opcode::BoundImageFetch, IR::Opcode::BindlessImageFetch,
+                                    IR::Opcode::BoundImageRead, IR::Opcode::BindlessImageRead}};
+
+    RescalingVisitor(IR::Program& program_, const Settings::ResolutionScalingInfo& scaling_)
+        : program{program_}, scaling{scaling_} {}
+
+    void Visit(IR::Block& block, IR::Inst& inst) override {
+        if (SHUFFLE_OPCODES.Contains(inst.GetOpcode())) {
+            shuffles.emplace_back(&block, &inst);
+        } else {
+            to_scale.emplace_back(&block, &inst);
         }
     }
-    for (IR::Block* const block : program.post_order_blocks) {
-        for (IR::Inst& inst : block->Instructions()) {
-            Visit(program, *block, inst);
+
+    void Finish() override {
+        if (program.stage == Stage::Fragment) {
+            for (const auto& [block, inst] : shuffles) {
+                VisitMark(*block, *inst);
+            }
+        }
+        for (const auto& [block, inst] : to_scale) {
+            VisitScale(scaling, program, *block, *inst);
         }
     }
+
+private:
+    IR::Program& program;
+    const Settings::ResolutionScalingInfo& scaling;
+    boost::container::small_vector<std::pair<IR::Block*, IR::Inst*>, 16> shuffles;
+    std::vector<std::pair<IR::Block*, IR::Inst*>> to_scale;
+};
+} // Anonymous namespace
+
+void RegisterRescalingPass(FusedWalk& walk, IR::Program& program,
+                           const Settings::ResolutionScalingInfo& scaling) {
+    walk.Emplace<RescalingVisitor>(program, scaling);
+}
+
+void RescalingPass(IR::Program& program, const Settings::ResolutionScalingInfo& scaling) {
+    FusedWalk walk;
+    RegisterRescalingPass(walk, program, scaling);
+    walk.Run(program);
 }
 
 } // namespace Shader::Optimization
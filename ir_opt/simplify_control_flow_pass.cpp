@@ -0,0 +1,399 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2026 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <algorithm>
+#include <optional>
+#include <vector>
+
+#include <shader_compiler/frontend/ir/basic_block.h>
+#include <shader_compiler/frontend/ir/value.h>
+#include <shader_compiler/ir_opt/passes.h>
+
+namespace Shader::Optimization {
+namespace {
+using NodeType = IR::AbstractSyntaxNode::Type;
+
+/// Removes the instructions of a block which are unused and have no side effects, walking the
+/// block backwards frees the arguments of removed instructions before they're visited
+void RemoveDeadInstructions(IR::Block& block) {
+    IR::Block::InstructionList& list{block.Instructions()};
+    auto it{list.end()};
+    while (it != list.begin()) {
+        --it;
+        if (!it->HasUses() && !it->MayHaveSideEffects()) {
+            it->Invalidate();
+            it = list.erase(it);
+        }
+    }
+}
+
+/// Replaces the phis taking the same value from every predecessor by the value itself
+void RemoveTrivialPhis(IR::Block& block) {
+    IR::Block::InstructionList& list{block.Instructions()};
+    for (auto it{list.begin()}; it != list.end() && it->GetOpcode() == IR::Opcode::Phi;) {
+        IR::Inst& phi{*it};
+        IR::Value same;
+        bool is_trivial{true};
+        const size_t num_args{phi.NumArgs()};
+        for (size_t index = 0; index < num_args && is_trivial; ++index) {
+            const IR::Value arg{phi.Arg(index).Resolve()};
+            if (arg == same || arg == IR::Value{&phi}) {
+                continue;
+            }
+            is_trivial = same.IsEmpty();
+            same = arg;
+        }
+        if (!is_trivial || same.IsEmpty()) {
+            ++it;
+            continue;
+        }
+        phi.ReplaceUsesWith(same);
+        it = list.erase(it);
+    }
+}
+
+/// Removes every instruction of a block which is no longer part of the program
+void ClearBlock(IR::Block& block) {
+    IR::Block::InstructionList& list{block.Instructions()};
+    while (!list.empty()) {
+        list.back().Invalidate();
+        list.pop_back();
+    }
+}
+
+/// The value of a branch condition when it is known at compile time
+std::optional<bool> ConstantCondition(const IR::U1& cond) {
+    IR::Value value{cond.Resolve()};
+    if (!value.IsImmediate() && value.InstRecursive()->GetOpcode() == IR::Opcode::ConditionRef) {
+        value = value.InstRecursive()->Arg(0).Resolve();
+    }
+    if (!value.IsImmediate()) {
+        return std::nullopt;
+    }
+    return value.U1();
+}
+
+class Pass {
+public:
+    explicit Pass(IR::Program& program_) : program{program_} {
+        removed_nodes.resize(program.syntax_list.size());
+        removed_blocks.resize(IR::NumBlockOrders(program));
+    }
+
+    /// Collapses ifs left without anything to execute in their body
+    bool CollapseEmptyIfs() {
+        // Nested nodes come after their parents, walking backwards collapses the inner ifs first
+        // so the ifs containing them may collapse as well
+        bool changed{};
+        for (size_t index = program.syntax_list.size(); index-- > 0;) {
+            if (program.syntax_list[index].type == NodeType::If) {
+                changed |= CollapseEmptyIf(index);
+            }
+        }
+        return changed;
+    }
+
+    /// Removes the branches whose condition is an immediate along with the code they skip
+    /// @note Repeats with a true condition are kept as loop safety checks may still exit them and
+    /// breaks with a true condition are kept as the code skipped belongs to the enclosing loop
+    bool FoldConstantBranches() {
+        const IR::AbstractSyntaxList& syntax_list{program.syntax_list};
+        bool changed{};
+        loop_nodes.clear();
+        for (size_t index = 0; index < syntax_list.size(); ++index) {
+            if (removed_nodes[index]) {
+                continue;
+            }
+            switch (syntax_list[index].type) {
+            case NodeType::If:
+                changed |= FoldIf(index);
+                break;
+            case NodeType::Break:
+                changed |= FoldBreak(index);
+                break;
+            case NodeType::Loop:
+                loop_nodes.push_back(index);
+                break;
+            case NodeType::Repeat:
+                changed |= FoldRepeat(index, loop_nodes.back());
+                loop_nodes.pop_back();
+                break;
+            default:
+                break;
+            }
+        }
+        return changed;
+    }
+
+    /// Drops the removed nodes and blocks from the program
+    void Compact() {
+        IR::AbstractSyntaxList& syntax_list{program.syntax_list};
+        size_t node_count{};
+        for (size_t index = 0; index < syntax_list.size(); ++index) {
+            if (!removed_nodes[index]) {
+                syntax_list[node_count++] = syntax_list[index];
+            }
+        }
+        syntax_list.resize(node_count);
+        // Removing edges keeps every remaining forward edge pointing down the post order
+        const auto is_removed{[this](const IR::Block* block) {
+            return removed_blocks[block->GetOrder()];
+        }};
+        std::erase_if(program.blocks, is_removed);
+        std::erase_if(program.post_order_blocks, is_removed);
+    }
+
+private:
+    /// Collapses an if whose body only has empty blocks branching to each other, the header then
+    /// branches to the merge block directly
+    bool CollapseEmptyIf(size_t if_index) {
+        const IR::AbstractSyntaxList& syntax_list{program.syntax_list};
+        if (if_index == 0 || syntax_list[if_index - 1].type != NodeType::Block) {
+            return false;
+        }
+        IR::Block* const header{syntax_list[if_index - 1].data.block};
+        IR::Block* const merge{syntax_list[if_index].data.if_node.merge};
+
+        body_nodes.clear();
+        size_t end_if_index{if_index + 1};
+        for (; end_if_index < syntax_list.size(); ++end_if_index) {
+            if (removed_nodes[end_if_index]) {
+                continue;
+            }
+            const IR::AbstractSyntaxNode& node{syntax_list[end_if_index]};
+            if (node.type == NodeType::EndIf) {
+                break;
+            }
+            if (node.type != NodeType::Block || !node.data.block->empty()) {
+                return false;
+            }
+            body_nodes.push_back(end_if_index);
+        }
+        if (body_nodes.empty() || end_if_index == syntax_list.size()) {
+            return false;
+        }
+        // The body must be a straight line from the header to the merge block
+        IR::Block* pred{header};
+        for (const size_t node_index : body_nodes) {
+            IR::Block* const block{syntax_list[node_index].data.block};
+            const auto preds{block->ImmPredecessors()};
+            if (preds.size() != 1 || preds.front() != pred || block->ImmSuccessors().size() != 1) {
+                return false;
+            }
+            pred = block;
+        }
+        IR::Block* const last_block{pred};
+        if (last_block->ImmSuccessors().front() != merge) {
+            return false;
+        }
+        // Phis can only be kept when they don't depend on the path taken
+        for (const IR::Inst& phi : merge->Instructions()) {
+            if (phi.GetOpcode() != IR::Opcode::Phi) {
+                break;
+            }
+            const IR::Value operand{PhiOperand(phi, last_block)};
+            if (operand.IsEmpty() || operand != PhiOperand(phi, header)) {
+                return false;
+            }
+        }
+
+        for (IR::Inst& phi : merge->Instructions()) {
+            if (phi.GetOpcode() != IR::Opcode::Phi) {
+                break;
+            }
+            phi.RemovePhiOperand(last_block);
+        }
+        pred = header;
+        for (const size_t node_index : body_nodes) {
+            IR::Block* const block{syntax_list[node_index].data.block};
+            pred->RemoveBranch(block);
+            removed_nodes[node_index] = true;
+            removed_blocks[block->GetOrder()] = true;
+            pred = block;
+        }
+        last_block->RemoveBranch(merge);
+        removed_nodes[if_index] = true;
+        removed_nodes[end_if_index] = true;
+        RemoveTrivialPhis(*merge);
+        RemoveCondition(*header, syntax_list[if_index].data.if_node.cond);
+        return true;
+    }
+
+    bool FoldIf(size_t if_index) {
+        const auto& if_node{program.syntax_list[if_index].data.if_node};
+        IR::Block* const header{BlockBefore(if_index)};
+        const std::optional<bool> cond{ConstantCondition(if_node.cond)};
+        if (!header || !cond || if_node.body == if_node.merge) {
+            return false;
+        }
+        const size_t end_if_index{FindEndIf(if_index)};
+        if (*cond) {
+            // The merge block stays reachable as long as the body doesn't always leave through a
+            // break or a return
+            if (if_node.merge->ImmPredecessors().size() < 2) {
+                return false;
+            }
+            RemoveEdge(header, if_node.merge);
+        } else {
+            header->RemoveBranch(if_node.body);
+            RemoveRegion(if_index + 1, end_if_index);
+        }
+        removed_nodes[if_index] = true;
+        removed_nodes[end_if_index] = true;
+        RemoveCondition(*header, if_node.cond);
+        return true;
+    }
+
+    bool FoldBreak(size_t break_index) {
+        const auto& break_node{program.syntax_list[break_index].data.break_node};
+        IR::Block* const header{BlockBefore(break_index)};
+        if (!header || ConstantCondition(break_node.cond) != false ||
+            break_node.merge == break_node.skip) {
+            return false;
+        }
+        RemoveEdge(header, break_node.merge);
+        removed_nodes[break_index] = true;
+        RemoveCondition(*header, break_node.cond);
+        return true;
+    }
+
+    /// Turns a loop which never repeats into straight code, loops which may be left by a break
+    /// are kept as the break needs a loop to leave
+    bool FoldRepeat(size_t repeat_index, size_t loop_index) {
+        const IR::AbstractSyntaxList& syntax_list{program.syntax_list};
+        const auto& repeat{syntax_list[repeat_index].data.repeat};
+        IR::Block* const continue_block{BlockBefore(repeat_index)};
+        if (!continue_block || ConstantCondition(repeat.cond) != false) {
+            return false;
+        }
+        for (size_t index = loop_index + 1; index < repeat_index; ++index) {
+            const IR::AbstractSyntaxNode& node{syntax_list[index]};
+            if (!removed_nodes[index] && node.type == NodeType::Break &&
+                node.data.break_node.merge == repeat.merge) {
+                return false;
+            }
+        }
+        RemoveEdge(continue_block, repeat.loop_header);
+        removed_nodes[loop_index] = true;
+        removed_nodes[repeat_index] = true;
+        RemoveCondition(*continue_block, repeat.cond);
+        return true;
+    }
+
+    /// The block ending with the branch of a node, it's the one right before the node
+    IR::Block* BlockBefore(size_t index) const {
+        const IR::AbstractSyntaxList& syntax_list{program.syntax_list};
+        if (index == 0 || syntax_list[index - 1].type != NodeType::Block) {
+            return nullptr;
+        }
+        return syntax_list[index - 1].data.block;
+    }
+
+    size_t FindEndIf(size_t if_index) const {
+        const IR::AbstractSyntaxList& syntax_list{program.syntax_list};
+        size_t depth{};
+        for (size_t index = if_index + 1;; ++index) {
+            if (syntax_list[index].type == NodeType::If) {
+                ++depth;
+            } else if (syntax_list[index].type == NodeType::EndIf && depth-- == 0) {
+                return index;
+            }
+        }
+    }
+
+    /// Removes a branch along with the phi operands it provides, phis may become trivial
+    static void RemoveEdge(IR::Block* pred, IR::Block* block) {
+        for (IR::Inst& phi : block->Instructions()) {
+            if (phi.GetOpcode() != IR::Opcode::Phi) {
+                break;
+            }
+            phi.RemovePhiOperand(pred);
+        }
+        pred->RemoveBranch(block);
+        RemoveTrivialPhis(*block);
+    }
+
+    /// Removes the nodes in a range of the abstract syntax list which is never executed along with
+    /// the branches leaving it
+    void RemoveRegion(size_t first, size_t last) {
+        const IR::AbstractSyntaxList& syntax_list{program.syntax_list};
+        for (size_t index = first; index < last; ++index) {
+            removed_nodes[index] = true;
+            if (syntax_list[index].type == NodeType::Block) {
+                removed_blocks[syntax_list[index].data.block->GetOrder()] = true;
+            }
+        }
+        for (size_t index = first; index < last; ++index) {
+            if (syntax_list[index].type != NodeType::Block) {
+                continue;
+            }
+            IR::Block* const block{syntax_list[index].data.block};
+            while (!block->ImmSuccessors().empty()) {
+                IR::Block* const successor{block->ImmSuccessors().back()};
+                if (removed_blocks[successor->GetOrder()]) {
+                    block->RemoveBranch(successor);
+                } else {
+                    RemoveEdge(block, successor);
+                }
+            }
+            ClearBlock(*block);
+        }
+    }
+
+    /// Removes the condition reference of a removed branch along with the instructions of its block
+    /// only computing it, so an enclosing if may see the block as empty
+    static void RemoveCondition(IR::Block& block, const IR::U1& cond) {
+        if (cond.IsImmediate()) {
+            return;
+        }
+        IR::Inst* const inst{cond.InstRecursive()};
+        IR::Block::InstructionList& list{block.Instructions()};
+        const auto is_inst{[inst](const IR::Inst& other) { return &other == inst; }};
+        const auto it{std::ranges::find_if(list.rbegin(), list.rend(), is_inst)};
+        if (it == list.rend() || inst->GetOpcode() != IR::Opcode::ConditionRef) {
+            return;
+        }
+        inst->Invalidate();
+        list.erase(IR::Block::InstructionList::s_iterator_to(*inst));
+        RemoveDeadInstructions(block);
+    }
+
+    static IR::Value PhiOperand(const IR::Inst& phi, const IR::Block* pred) {
+        const size_t num_args{phi.NumArgs()};
+        for (size_t index = 0; index < num_args; ++index) {
+            if (phi.PhiBlock(index) == pred) {
+                return phi.Arg(index).Resolve();
+            }
+        }
+        return IR::Value{};
+    }
+
+    IR::Program& program;
+    std::vector<bool> removed_nodes;
+    std::vector<bool> removed_blocks;
+    std::vector<size_t> body_nodes;
+    std::vector<size_t> loop_nodes;
+};
+} // Anonymous namespace
+
+void ConstantBranchFoldingPass(IR::Program& program) {
+    Pass pass{program};
+    if (pass.FoldConstantBranches()) {
+        pass.Compact();
+    }
+}
+
+void SimplifyControlFlowPass(IR::Program& program) {
+    // Conditions of removed branches and the phis only feeding them are dead once ifs collapse,
+    // removing them may leave the phis of enclosing merge blocks independent of the path taken
+    while (true) {
+        Pass pass{program};
+        if (!pass.CollapseEmptyIfs()) {
+            break;
+        }
+        pass.Compact();
+        DeadCodeEliminationPass(program);
+    }
+}
+
+} // namespace Shader::Optimization
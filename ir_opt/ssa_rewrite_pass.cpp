@@ -14,7 +14,10 @@
 //
 
 #include <range/v3/algorithm.hpp>
+#include <array>
 #include <deque>
+#include <memory>
+#include <memory_resource>
 #include <span>
 #include <variant>
 #include <vector>
@@ -53,72 +56,78 @@ struct IndirectBranchVariable {
 
 using Variant = std::variant<IR::Reg, IR::Pred, ZeroFlagTag, SignFlagTag, CarryFlagTag,
                              OverflowFlagTag, GotoVariable, IndirectBranchVariable>;
-using ValueMap = boost::container::flat_map<IR::Block*, IR::Value>;
-
-struct DefTable {
-    const IR::Value& Def(IR::Block* block, IR::Reg variable) {
-        return block->SsaRegValue(variable);
-    }
-    void SetDef(IR::Block* block, IR::Reg variable, const IR::Value& value) {
-        block->SetSsaRegValue(variable, value);
-    }
-
-    const IR::Value& Def(IR::Block* block, IR::Pred variable) {
-        return preds[IR::PredIndex(variable)][block];
-    }
-    void SetDef(IR::Block* block, IR::Pred variable, const IR::Value& value) {
-        preds[IR::PredIndex(variable)].insert_or_assign(block, value);
-    }
-
-    const IR::Value& Def(IR::Block* block, GotoVariable variable) {
-        return goto_vars[variable.index][block];
-    }
-    void SetDef(IR::Block* block, GotoVariable variable, const IR::Value& value) {
-        goto_vars[variable.index].insert_or_assign(block, value);
-    }
+/// Dense index of a variable, registers come first as they're by far the most common
+constexpr size_t VariableIndex(IR::Reg variable) noexcept {
+    return IR::RegIndex(variable);
+}
+constexpr size_t VariableIndex(IR::Pred variable) noexcept {
+    return IR::NUM_REGS + IR::PredIndex(variable);
+}
+constexpr size_t VariableIndex(ZeroFlagTag) noexcept {
+    return IR::NUM_REGS + IR::NUM_USER_PREDS;
+}
+constexpr size_t VariableIndex(SignFlagTag) noexcept {
+    return IR::NUM_REGS + IR::NUM_USER_PREDS + 1;
+}
+constexpr size_t VariableIndex(CarryFlagTag) noexcept {
+    return IR::NUM_REGS + IR::NUM_USER_PREDS + 2;
+}
+constexpr size_t VariableIndex(OverflowFlagTag) noexcept {
+    return IR::NUM_REGS + IR::NUM_USER_PREDS + 3;
+}
+constexpr size_t VariableIndex(IndirectBranchVariable) noexcept {
+    return IR::NUM_REGS + IR::NUM_USER_PREDS + 4;
+}
+constexpr size_t VariableIndex(GotoVariable variable) noexcept {
+    return IR::NUM_REGS + IR::NUM_USER_PREDS + 5 + variable.index;
+}
 
-    const IR::Value& Def(IR::Block* block, IndirectBranchVariable) {
-        return indirect_branch_var[block];
-    }
-    void SetDef(IR::Block* block, IndirectBranchVariable, const IR::Value& value) {
-        indirect_branch_var.insert_or_assign(block, value);
-    }
+/**
+ * @brief The current definition of every variable in every block, indexed by block order
+ * @note Definitions are stored in pages of consecutive variables which are only allocated once a
+ * variable in them is defined in the block, blocks only ever touch a handful of pages. All memory
+ * comes from the compilation arena and is released along with it
+ */
+class DefTable {
+public:
+    explicit DefTable(size_t num_blocks, std::pmr::memory_resource& memory_)
+        : memory{&memory_}, blocks(num_blocks, memory) {}
 
-    const IR::Value& Def(IR::Block* block, ZeroFlagTag) {
-        return zero_flag[block];
-    }
-    void SetDef(IR::Block* block, ZeroFlagTag, const IR::Value& value) {
-        zero_flag.insert_or_assign(block, value);
+    template <typename Type>
+    const IR::Value& Def(IR::Block* block, Type variable) const noexcept {
+        static const IR::Value empty{};
+        const std::pmr::vector<Page*>& pages{blocks[block->GetOrder()]};
+        const size_t index{VariableIndex(variable)};
+        const size_t page_index{index / PAGE_SIZE};
+        if (page_index >= pages.size() || pages[page_index] == nullptr) {
+            return empty;
+        }
+        return (*pages[page_index])[index % PAGE_SIZE];
     }
 
-    const IR::Value& Def(IR::Block* block, SignFlagTag) {
-        return sign_flag[block];
-    }
-    void SetDef(IR::Block* block, SignFlagTag, const IR::Value& value) {
-        sign_flag.insert_or_assign(block, value);
+    template <typename Type>
+    void SetDef(IR::Block* block, Type variable, const IR::Value& value) {
+        std::pmr::vector<Page*>& pages{blocks[block->GetOrder()]};
+        const size_t index{VariableIndex(variable)};
+        const size_t page_index{index / PAGE_SIZE};
+        if (page_index >= pages.size()) {
+            pages.resize(page_index + 1);
+        }
+        Page*& page{pages[page_index]};
+        if (page == nullptr) {
+            page = std::construct_at(
+                static_cast<Page*>(memory->allocate(sizeof(Page), alignof(Page))));
+        }
+        (*page)[index % PAGE_SIZE] = value;
     }
 
-    const IR::Value& Def(IR::Block* block, CarryFlagTag) {
-        return carry_flag[block];
-    }
-    void SetDef(IR::Block* block, CarryFlagTag, const IR::Value& value) {
-        carry_flag.insert_or_assign(block, value);
-    }
+private:
+    static constexpr size_t PAGE_SIZE{32};
 
-    const IR::Value& Def(IR::Block* block, OverflowFlagTag) {
-        return overflow_flag[block];
-    }
-    void SetDef(IR::Block* block, OverflowFlagTag, const IR::Value& value) {
-        overflow_flag.insert_or_assign(block, value);
-    }
+    using Page = std::array<IR::Value, PAGE_SIZE>;
 
-    std::array<ValueMap, IR::NUM_USER_PREDS> preds;
-    boost::container::flat_map<u32, ValueMap> goto_vars;
-    ValueMap indirect_branch_var;
-    ValueMap zero_flag;
-    ValueMap sign_flag;
-    ValueMap carry_flag;
-    ValueMap overflow_flag;
+    std::pmr::memory_resource* memory;
+    std::pmr::vector<std::pmr::vector<Page*>> blocks;
 };
 
 IR::Opcode UndefOpcode(IR::Reg) noexcept {
@@ -159,6 +168,9 @@ struct ReadState {
 
 class Pass {
 public:
+    explicit Pass(size_t num_blocks, std::pmr::memory_resource& memory)
+        : current_def{num_blocks, memory} {}
+
     template <typename Type>
     void WriteVariable(Type variable, IR::Block* block, const IR::Value& value) {
         current_def.SetDef(block, variable, value);
@@ -289,9 +301,12 @@ private:
             same = IR::Value{&*reinsert_point};
             ++reinsert_point;
         }
-        // Reinsert the phi node and reroute all its uses to the "same" value
+        // Reinsert the phi node and reroute all its uses to the "same" value, definitions recorded
+        // for other blocks may still refer to the phi so it's kept as an identity of the value
         list.insert(reinsert_point, phi);
         phi.ReplaceUsesWith(same);
+        phi.ReplaceOpcode(IR::Opcode::Identity);
+        phi.SetArg(0, same);
         // TODO: Try to recursively remove all phi users, which might have become trivial
         return same;
     }
@@ -301,7 +316,8 @@ private:
     DefTable current_def;
 };
 
-void VisitInst(Pass& pass, IR::Block* block, IR::Inst& inst) {
+/// Returns true when the instruction was a read which has been replaced and can be removed
+bool VisitInst(Pass& pass, IR::Block* block, IR::Inst& inst) {
     switch (inst.GetOpcode()) {
     case IR::Opcode::SetRegister:
         if (const IR::Reg reg{inst.Arg(0).Reg()}; reg != IR::Reg::RZ) {
@@ -334,39 +350,49 @@ void VisitInst(Pass& pass, IR::Block* block, IR::Inst& inst) {
     case IR::Opcode::GetRegister:
         if (const IR::Reg reg{inst.Arg(0).Reg()}; reg != IR::Reg::RZ) {
             inst.ReplaceUsesWith(pass.ReadVariable(reg, block));
+            return true;
         }
         break;
     case IR::Opcode::GetPred:
         if (const IR::Pred pred{inst.Arg(0).Pred()}; pred != IR::Pred::PT) {
             inst.ReplaceUsesWith(pass.ReadVariable(pred, block));
+            return true;
         }
         break;
     case IR::Opcode::GetGotoVariable:
         inst.ReplaceUsesWith(pass.ReadVariable(GotoVariable{inst.Arg(0).U32()}, block));
-        break;
+        return true;
     case IR::Opcode::GetIndirectBranchVariable:
         inst.ReplaceUsesWith(pass.ReadVariable(IndirectBranchVariable{}, block));
-        break;
+        return true;
     case IR::Opcode::GetZFlag:
         inst.ReplaceUsesWith(pass.ReadVariable(ZeroFlagTag{}, block));
-        break;
+        return true;
     case IR::Opcode::GetSFlag:
         inst.ReplaceUsesWith(pass.ReadVariable(SignFlagTag{}, block));
-        break;
+        return true;
     case IR::Opcode::GetCFlag:
         inst.ReplaceUsesWith(pass.ReadVariable(CarryFlagTag{}, block));
-        break;
+        return true;
     case IR::Opcode::GetOFlag:
         inst.ReplaceUsesWith(pass.ReadVariable(OverflowFlagTag{}, block));
-        break;
+        return true;
     default:
         break;
     }
+    return false;
 }
 
 void VisitBlock(Pass& pass, IR::Block* block) {
-    for (IR::Inst& inst : block->Instructions()) {
-        VisitInst(pass, block, inst);
+    IR::Block::InstructionList& list{block->Instructions()};
+    for (auto it{list.begin()}; it != list.end();) {
+        if (VisitInst(pass, block, *it)) {
+            // Reads are only referenced by instructions which now use the definition directly, so
+            // they are removed right away instead of by dead code elimination
+            it = list.erase(it);
+        } else {
+            ++it;
+        }
     }
     pass.SealBlock(block);
 }
@@ -393,7 +419,11 @@ IR::Type GetConcreteType(IR::Inst* inst) {
 } // Anonymous namespace
 
 void SsaRewritePass(IR::Program& program) {
-    Pass pass;
+    if (program.blocks.empty()) {
+        return;
+    }
+    // Reads walk into predecessors even when they have been found unreachable, these are counted
+    Pass pass{IR::NumBlockOrders(program), program.blocks.front()->Memory()};
     const auto end{program.post_order_blocks.rend()};
     for (auto block = program.post_order_blocks.rbegin(); block != end; ++block) {
         VisitBlock(pass, *block);
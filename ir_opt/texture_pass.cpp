@@ -13,6 +13,7 @@
 #include <shader_compiler/frontend/ir/breadth_first_search.h>
 #include <shader_compiler/frontend/ir/ir_emitter.h>
 #include <shader_compiler/host_translate_info.h>
+#include <shader_compiler/ir_opt/fused_walk.h>
 #include <shader_compiler/ir_opt/passes.h>
 #include <shader_compiler/shader_info.h>
 
@@ -117,65 +118,6 @@ IR::Opcode IndexedInstruction(const IR::Inst& inst) {
     }
 }
 
-bool IsBindless(const IR::Inst& inst) {
-    switch (inst.GetOpcode()) {
-    case IR::Opcode::BindlessImageSampleImplicitLod:
-    case IR::Opcode::BindlessImageSampleExplicitLod:
-    case IR::Opcode::BindlessImageSampleDrefImplicitLod:
-    case IR::Opcode::BindlessImageSampleDrefExplicitLod:
-    case IR::Opcode::BindlessImageGather:
-    case IR::Opcode::BindlessImageGatherDref:
-    case IR::Opcode::BindlessImageFetch:
-    case IR::Opcode::BindlessImageQueryDimensions:
-    case IR::Opcode::BindlessImageQueryLod:
-    case IR::Opcode::BindlessImageGradient:
-    case IR::Opcode::BindlessImageRead:
-    case IR::Opcode::BindlessImageWrite:
-    case IR::Opcode::BindlessImageAtomicIAdd32:
-    case IR::Opcode::BindlessImageAtomicSMin32:
-    case IR::Opcode::BindlessImageAtomicUMin32:
-    case IR::Opcode::BindlessImageAtomicSMax32:
-    case IR::Opcode::BindlessImageAtomicUMax32:
-    case IR::Opcode::BindlessImageAtomicInc32:
-    case IR::Opcode::BindlessImageAtomicDec32:
-    case IR::Opcode::BindlessImageAtomicAnd32:
-    case IR::Opcode::BindlessImageAtomicOr32:
-    case IR::Opcode::BindlessImageAtomicXor32:
-    case IR::Opcode::BindlessImageAtomicExchange32:
-        return true;
-    case IR::Opcode::BoundImageSampleImplicitLod:
-    case IR::Opcode::BoundImageSampleExplicitLod:
-    case IR::Opcode::BoundImageSampleDrefImplicitLod:
-    case IR::Opcode::BoundImageSampleDrefExplicitLod:
-    case IR::Opcode::BoundImageGather:
-    case IR::Opcode::BoundImageGatherDref:
-    case IR::Opcode::BoundImageFetch:
-    case IR::Opcode::BoundImageQueryDimensions:
-    case IR::Opcode::BoundImageQueryLod:
-    case IR::Opcode::BoundImageGradient:
-    case IR::Opcode::BoundImageRead:
-    case IR::Opcode::BoundImageWrite:
-    case IR::Opcode::BoundImageAtomicIAdd32:
-    case IR::Opcode::BoundImageAtomicSMin32:
-    case IR::Opcode::BoundImageAtomicUMin32:
-    case IR::Opcode::BoundImageAtomicSMax32:
-    case IR::Opcode::BoundImageAtomicUMax32:
-    case IR::Opcode::BoundImageAtomicInc32:
-    case IR::Opcode::BoundImageAtomicDec32:
-    case IR::Opcode::BoundImageAtomicAnd32:
-    case IR::Opcode::BoundImageAtomicOr32:
-    case IR::Opcode::BoundImageAtomicXor32:
-    case IR::Opcode::BoundImageAtomicExchange32:
-        return false;
-    default:
-        throw InvalidArgument("Invalid opcode {}", inst.GetOpcode());
-    }
-}
-
-bool IsTextureInstruction(const IR::Inst& inst) {
-    return IndexedInstruction(inst) != IR::Opcode::Void;
-}
-
 std::optional<ConstBufferAddr> TryGetConstBuffer(const IR::Inst* inst, Environment& env);
 
 std::optional<ConstBufferAddr> Track(const IR::Value& value, Environment& env) {
@@ -330,7 +272,7 @@ std::optional<ConstBufferAddr> TryGetConstBuffer(const IR::Inst* inst, Environme
 
 TextureInst MakeInst(Environment& env, IR::Block* block, IR::Inst& inst) {
     ConstBufferAddr addr;
-    if (IsBindless(inst)) {
+    if (BINDLESS_TEXTURE_OPCODES.Contains(inst.GetOpcode())) {
         const std::optional<ConstBufferAddr> track_addr{Track(inst.Arg(0), env)};
         if (!track_addr) {
             throw NotImplementedException("Failed to track bindless texture constant buffer");
@@ -493,18 +435,9 @@ void PatchTexelFetch(IR::Block& block, IR::Inst& inst, TexturePixelFormat pixel_
                               ir.FPMul(ir.ConvertSToF(32, 32, ir.BitCast<IR::S32>(w)), max_value));
     inst.ReplaceUsesWith(converted);
 }
-} // Anonymous namespace
 
-void TexturePass(Environment& env, IR::Program& program, const HostTranslateInfo& host_info) {
-    TextureInstVector to_replace;
-    for (IR::Block* const block : program.post_order_blocks) {
-        for (IR::Inst& inst : block->Instructions()) {
-            if (!IsTextureInstruction(inst)) {
-                continue;
-            }
-            to_replace.push_back(MakeInst(env, block, inst));
-        }
-    }
+void ReplaceTextures(Environment& env, IR::Program& program, const HostTranslateInfo& host_info,
+                     TextureInstVector& to_replace) {
     // Sort instructions to visit textures by constant buffer index, then by offset
     ranges::sort(to_replace, [](const auto& lhs, const auto& rhs) {
         return lhs.cbuf.offset < rhs.cbuf.offset;
@@ -650,6 +583,41 @@ void TexturePass(Environment& env, IR::Program& program, const HostTranslateInfo
     }
 }
 
+/// Collects the texture instructions of a program, descriptors are assigned once all are known
+class TextureVisitor final : public InstructionVisitor {
+public:
+    static constexpr OpcodeSet OPCODES{TEXTURE_OPCODES};
+
+    TextureVisitor(Environment& env_, IR::Program& program_, const HostTranslateInfo& host_info_)
+        : env{env_}, program{program_}, host_info{host_info_} {}
+
+    void Visit(IR::Block& block, IR::Inst& inst) override {
+        to_replace.push_back(MakeInst(env, &block, inst));
+    }
+
+    void Finish() override {
+        ReplaceTextures(env, program, host_info, to_replace);
+    }
+
+private:
+    Environment& env;
+    IR::Program& program;
+    const HostTranslateInfo& host_info;
+    TextureInstVector to_replace;
+};
+} // Anonymous namespace
+
+void RegisterTexturePass(FusedWalk& walk, Environment& env, IR::Program& program,
+                         const HostTranslateInfo& host_info) {
+    walk.Emplace<TextureVisitor>(env, program, host_info);
+}
+
+void TexturePass(Environment& env, IR::Program& program, const HostTranslateInfo& host_info) {
+    FusedWalk walk;
+    RegisterTexturePass(walk, env, program, host_info);
+    walk.Run(program);
+}
+
 void JoinTextureInfo(Info& base, Info& source) {
     Descriptors descriptors{
         base.texture_buffer_descriptors,
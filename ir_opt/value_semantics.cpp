@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2026 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <array>
+#include <string_view>
+
+#include <shader_compiler/frontend/ir/basic_block.h>
+#include <shader_compiler/ir_opt/value_semantics.h>
+
+namespace Shader::Optimization {
+namespace {
+constexpr size_t NUM_OPCODES{std::size(IR::Detail::META_TABLE)};
+
+constexpr std::array PURE_PREFIXES{
+    std::string_view{"GetCbuf"},
+    std::string_view{"Composite"},
+    std::string_view{"Select"},
+    std::string_view{"BitCast"},
+    std::string_view{"Pack"},
+    std::string_view{"Unpack"},
+    std::string_view{"FP"},
+    std::string_view{"IAdd"},
+    std::string_view{"ISub"},
+    std::string_view{"IMul"},
+    std::string_view{"SDiv"},
+    std::string_view{"UDiv"},
+    std::string_view{"INeg"},
+    std::string_view{"IAbs"},
+    std::string_view{"Shift"},
+    std::string_view{"Bitwise"},
+    std::string_view{"BitField"},
+    std::string_view{"BitReverse"},
+    std::string_view{"BitCount"},
+    std::string_view{"FindSMsb"},
+    std::string_view{"FindUMsb"},
+    std::string_view{"SMin"},
+    std::string_view{"UMin"},
+    std::string_view{"SMax"},
+    std::string_view{"UMax"},
+    std::string_view{"SClamp"},
+    std::string_view{"UClamp"},
+    std::string_view{"SLess"},
+    std::string_view{"ULess"},
+    std::string_view{"SGreater"},
+    std::string_view{"UGreater"},
+    std::string_view{"IEqual"},
+    std::string_view{"INotEqual"},
+    std::string_view{"Logical"},
+    std::string_view{"Convert"},
+    std::string_view{"WorkgroupId"},
+    std::string_view{"LocalInvocationId"},
+    std::string_view{"YDirection"},
+    std::string_view{"ResolutionDownFactor"},
+    std::string_view{"RenderArea"},
+    std::string_view{"LaneId"},
+    std::string_view{"SubgroupEqMask"},
+    std::string_view{"SubgroupLtMask"},
+    std::string_view{"SubgroupLeMask"},
+    std::string_view{"SubgroupGtMask"},
+    std::string_view{"SubgroupGeMask"},
+    std::string_view{"IsTextureScaled"},
+    std::string_view{"IsImageScaled"},
+};
+
+constexpr ValueSemantics ComputeSemantics(std::string_view name) {
+    if (name == "GetAttribute" || name == "GetAttributeU32") {
+        return ValueSemantics::Attribute;
+    }
+    for (const std::string_view prefix : PURE_PREFIXES) {
+        if (name.starts_with(prefix)) {
+            return ValueSemantics::Pure;
+        }
+    }
+    return ValueSemantics::Varying;
+}
+
+constexpr std::array<ValueSemantics, NUM_OPCODES> SEMANTICS_TABLE{[] {
+    std::array<ValueSemantics, NUM_OPCODES> table{};
+    for (size_t opcode = 0; opcode < NUM_OPCODES; ++opcode) {
+        table[opcode] = ComputeSemantics(IR::Detail::META_TABLE[opcode].name);
+    }
+    return table;
+}()};
+
+static_assert(SEMANTICS_TABLE[static_cast<size_t>(IR::Opcode::GetCbufU32)] ==
+              ValueSemantics::Pure);
+static_assert(SEMANTICS_TABLE[static_cast<size_t>(IR::Opcode::GetAttributeIndexed)] ==
+              ValueSemantics::Varying);
+static_assert(SEMANTICS_TABLE[static_cast<size_t>(IR::Opcode::SubgroupBallot)] ==
+              ValueSemantics::Varying);
+static_assert(SEMANTICS_TABLE[static_cast<size_t>(IR::Opcode::FSwizzleAdd)] ==
+              ValueSemantics::Varying);
+} // Anonymous namespace
+
+ValueSemantics SemanticsOf(IR::Opcode opcode) noexcept {
+    return SEMANTICS_TABLE[static_cast<size_t>(opcode)];
+}
+
+bool WritesAttributes(const IR::Program& program) {
+    for (const IR::Block* const block : program.blocks) {
+        for (const IR::Inst& inst : block->Instructions()) {
+            const IR::Opcode opcode{inst.GetOpcode()};
+            if (opcode == IR::Opcode::SetAttribute || opcode == IR::Opcode::SetAttributeIndexed) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+} // namespace Shader::Optimization
@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2026 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <shader_compiler/common/common_types.h>
+#include <shader_compiler/frontend/ir/opcodes.h>
+#include <shader_compiler/frontend/ir/program.h>
+
+namespace Shader::Optimization {
+
+/// What the result of an opcode depends on besides its arguments
+enum class ValueSemantics : u8 {
+    Varying,   ///< Reads state which may change or depends on the active invocations
+    Pure,      ///< Only depends on its arguments and on state constant through an invocation
+    Attribute, ///< Reads attributes, they're constant unless the program writes any
+};
+
+[[nodiscard]] ValueSemantics SemanticsOf(IR::Opcode opcode) noexcept;
+
+/// Checks if any instruction of the program writes attributes
+[[nodiscard]] bool WritesAttributes(const IR::Program& program);
+
+/**
+ * @brief Checks if instructions with an opcode compute the same value wherever they are, so they
+ * may be merged or moved as long as their arguments are available
+ */
+[[nodiscard]] inline bool IsInvariant(IR::Opcode opcode, bool writes_attributes) noexcept {
+    const ValueSemantics semantics{SemanticsOf(opcode)};
+    return semantics == ValueSemantics::Pure ||
+           (semantics == ValueSemantics::Attribute && !writes_attributes);
+}
+
+} // namespace Shader::Optimization
@@ -24,21 +24,24 @@ public:
     }
 
     void ReleaseContents() {
-        if (chunks.empty()) {
-            return;
-        }
-        Chunk& root{chunks.front()};
-        if (root.used_objects == root.num_objects) {
-            // Root chunk has been filled, squash allocations into it
-            const size_t total_objects{root.num_objects + new_chunk_size * (chunks.size() - 1)};
-            chunks.clear();
-            chunks.emplace_back(total_objects);
-        } else {
-            root.Release();
-            chunks.resize(1);
+        Reclaim(true);
+    }
+
+    /**
+     * @brief Forgets every object without destroying it, the storage is kept like ReleaseContents
+     * @note Objects must not own any memory which isn't reclaimed alongside the pool
+     */
+    void DiscardContents() {
+        Reclaim(false);
+    }
+
+    /// The amount of objects created since the contents were last released
+    [[nodiscard]] size_t NumObjects() const noexcept {
+        size_t num_objects{};
+        for (const Chunk& chunk : chunks) {
+            num_objects += chunk.used_objects;
         }
-        chunks.shrink_to_fit();
-        node = &chunks.front();
+        return num_objects;
     }
 
 private:
@@ -85,6 +88,30 @@ private:
         std::unique_ptr<Storage[]> storage;
     };
 
+    void Reclaim(bool destroy) {
+        if (chunks.empty()) {
+            return;
+        }
+        Chunk& root{chunks.front()};
+        const bool is_root_full{root.used_objects == root.num_objects};
+        if (!destroy) {
+            for (Chunk& chunk : chunks) {
+                chunk.used_objects = 0;
+            }
+        }
+        if (is_root_full) {
+            // Root chunk has been filled, squash allocations into it
+            const size_t total_objects{root.num_objects + new_chunk_size * (chunks.size() - 1)};
+            chunks.clear();
+            chunks.emplace_back(total_objects);
+        } else {
+            root.Release();
+            chunks.resize(1);
+        }
+        chunks.shrink_to_fit();
+        node = &chunks.front();
+    }
+
     [[nodiscard]] T* Memory() {
         Chunk* const chunk{FreeChunk()};
         return &chunk->storage[chunk->used_objects++].object;